@@ -1,24 +1,31 @@
 import 'dart:async';
-import 'dart:ffi' as ffi;
 import 'package:flutter_bloc/flutter_bloc.dart';
 import 'ffi_bridge.dart';
 
 // --- State Definition ---
+const int spectrumBandCount = 64;
+
 class DspState {
   final bool isRunning;
   final double rmsLevel;
-  final List<double> fftData; // 512 frequency bins
+  final double truePeak;      // dBTP with fall-back ballistics
+  final double truePeakHold;  // dBTP, held for 2 s
+  final List<double> spectrumBands; // Log-spaced bands, normalized 0..1
   final double mediaTime;     // Sample-accurate clock from C++
   final String subtitleText;  // Current active subtitle
   final double masterGain;    // Current gain (0.0 - 1.0)
+  final int startError;       // StartError of the last failed start, StartError.none otherwise
 
   const DspState({
     required this.isRunning,
     required this.rmsLevel,
-    required this.fftData,
+    required this.truePeak,
+    required this.truePeakHold,
+    required this.spectrumBands,
     required this.mediaTime,
     required this.subtitleText,
     required this.masterGain,
+    this.startError = StartError.none,
   });
 
   // Factory for initial state
@@ -26,7 +33,9 @@ class DspState {
     return DspState(
       isRunning: false,
       rmsLevel: 0.0,
-      fftData: List.filled(512, 0.0),
+      truePeak: double.negativeInfinity,
+      truePeakHold: double.negativeInfinity,
+      spectrumBands: List.filled(spectrumBandCount, 0.0),
       mediaTime: 0.0,
       subtitleText: "",
       masterGain: 1.0,
@@ -36,18 +45,24 @@ class DspState {
   DspState copyWith({
     bool? isRunning,
     double? rmsLevel,
-    List<double>? fftData,
+    double? truePeak,
+    double? truePeakHold,
+    List<double>? spectrumBands,
     double? mediaTime,
     String? subtitleText,
     double? masterGain,
+    int? startError,
   }) {
     return DspState(
       isRunning: isRunning ?? this.isRunning,
       rmsLevel: rmsLevel ?? this.rmsLevel,
-      fftData: fftData ?? this.fftData,
+      truePeak: truePeak ?? this.truePeak,
+      truePeakHold: truePeakHold ?? this.truePeakHold,
+      spectrumBands: spectrumBands ?? this.spectrumBands,
       mediaTime: mediaTime ?? this.mediaTime,
       subtitleText: subtitleText ?? this.subtitleText,
       masterGain: masterGain ?? this.masterGain,
+      startError: startError ?? this.startError,
     );
   }
 }
@@ -65,6 +80,9 @@ class _UpdateTelemetry extends DspEvent {}
 class DspBloc extends Bloc<DspEvent, DspState> {
   final DspBridge _bridge;
   Timer? _telemetryTimer;
+  int _subtitleGeneration = -1;
+  bool _engineStarted = false; // Toggling after the first start only pauses/resumes
+  bool _startPending = false;   // Async start not reported yet
 
   DspBloc(this._bridge) : super(DspState.initial()) {
     on<ToggleEngine>(_onToggleEngine);
@@ -74,10 +92,19 @@ class DspBloc extends Bloc<DspEvent, DspState> {
 
   void _onToggleEngine(ToggleEngine event, Emitter<DspState> emit) {
     if (state.isRunning) {
-      // Stop logic
-      _bridge.stopEngine();
+      // Pause logic: the device stays initialized for an instant resume
+      _bridge.pauseEngine();
       _telemetryTimer?.cancel();
-      emit(DspState.initial());
+      emit(state.copyWith(
+        isRunning: false,
+        rmsLevel: 0.0,
+        truePeak: double.negativeInfinity,
+        truePeakHold: double.negativeInfinity,
+      ));
+    } else if (_engineStarted) {
+      if (!_bridge.resumeEngine()) return; // Device would not restart: stay paused
+      _startTelemetry();
+      emit(state.copyWith(isRunning: true));
     } else {
       // --- STARTUP LOGIC: MODE 1 (PLAYBACK) ---
       
@@ -87,7 +114,9 @@ class DspBloc extends Bloc<DspEvent, DspState> {
 
       // Initialize Engine in Mode 1 (Playback)
       // This will decode the file, play it to speakers, and analyze it.
-      _bridge.initEngine(mode: 1, filePath: testFilePath);
+      // Runs on a native worker so the UI never waits on I/O or the backend.
+      _bridge.startEngineAsync(mode: 1, filePath: testFilePath);
+      _startPending = true;
       
       // --- INJECT SYNC TEST SUBTITLES ---
       // These timestamps will match the audio file's playback time
@@ -110,15 +139,19 @@ READY FOR IOS DEPLOYMENT
       _bridge.loadSubtitles(mockSrt);
       // -----------------------------
 
-      // Start Telemetry Loop (60 FPS / ~16ms)
-      _telemetryTimer = Timer.periodic(const Duration(milliseconds: 16), (_) {
-        add(_UpdateTelemetry());
-      });
-      
-      emit(state.copyWith(isRunning: true));
+      _engineStarted = true;
+      _startTelemetry();
+      emit(state.copyWith(isRunning: true, startError: StartError.none));
     }
   }
 
+  // Start Telemetry Loop (60 FPS / ~16ms)
+  void _startTelemetry() {
+    _telemetryTimer = Timer.periodic(const Duration(milliseconds: 16), (_) {
+      add(_UpdateTelemetry());
+    });
+  }
+
   void _onSetGain(SetGain event, Emitter<DspState> emit) {
     _bridge.setGain(event.gain);
     emit(state.copyWith(masterGain: event.gain));
@@ -127,31 +160,47 @@ READY FOR IOS DEPLOYMENT
   void _onUpdateTelemetry(_UpdateTelemetry event, Emitter<DspState> emit) {
     if (!state.isRunning) return;
 
+    if (_startPending) {
+      final report = _bridge.getStartReport();
+      if (report == null || report.state == StartState.starting) return;
+      _startPending = false;
+      if (report.state == StartState.failed) {
+        _telemetryTimer?.cancel();
+        _engineStarted = false;
+        emit(DspState.initial().copyWith(startError: report.error));
+        return;
+      }
+    }
+
     // 1. Fetch RMS Level
     final double level = _bridge.getRmsLevel();
     
+    // 1b. Fetch true-peak meter (ballistics run per sample in C++)
+    final peaks = _bridge.getPeaks();
+
     // 2. Fetch Media Time (Driven by Audio Samples)
     final double time = _bridge.getMediaTime();
 
-    // 3. Fetch FFT Data (Direct Pointer Access)
-    final ffi.Pointer<ffi.Float> ptr = _bridge.getFftArray();
-    List<double> currentFft = state.fftData; 
-    
-    if (ptr != ffi.nullptr) {
-      // Fast copy from C heap to Dart heap for rendering
-      currentFft = List<double>.from(ptr.asTypedList(512));
-    }
-
-    // 4. Fetch Subtitles (Synced to Media Time)
-    final int subIdx = _bridge.getSubtitleIndex();
-    String currentSub = "";
-    if (subIdx != -1) {
-      currentSub = _bridge.getSubtitleText(subIdx);
+    // 3. Fetch Spectrum Bands (binning and dB conversion done in C++)
+    List<double> bands = _bridge.getSpectrumBands(spectrumBandCount);
+    if (bands.isEmpty) bands = state.spectrumBands;
+
+    // 4. Fetch Subtitles (Synced to Media Time), only when any track changed
+    String currentSub = state.subtitleText;
+    final int subGeneration = _bridge.getSubtitleGeneration();
+    if (subGeneration != _subtitleGeneration) {
+      _subtitleGeneration = subGeneration;
+      currentSub = _bridge
+          .getAllActiveSubtitles()
+          .map((e) => _bridge.getTrackSubtitleText(e.$1, e.$2))
+          .join("\n");
     }
 
     emit(state.copyWith(
       rmsLevel: level,
-      fftData: currentFft,
+      truePeak: peaks?.truePeak,
+      truePeakHold: peaks?.truePeakHold,
+      spectrumBands: bands,
       mediaTime: time,
       subtitleText: currentSub,
     ));
@@ -1,7 +1,225 @@
 import 'dart:ffi' as ffi;
 import 'dart:io';
+import 'dart:typed_data';
 import 'package:ffi/ffi.dart';
 
+// --- C++ Structs ---
+// Mirrors SubtitleCueInfo in src/subtitles.h
+final class SubtitleCueInfo extends ffi.Struct {
+  @ffi.Int32()
+  external int index;
+  @ffi.Int16()
+  external int layer;
+  @ffi.Uint16()
+  external int styleId;
+  @ffi.Double()
+  external double startTime;
+  @ffi.Double()
+  external double endTime;
+  external ffi.Pointer<Utf8> text;
+  @ffi.Int32()
+  external int textLength;
+}
+
+// Mirrors SubtitleActiveEntry in src/subtitles.h
+final class SubtitleActiveEntry extends ffi.Struct {
+  @ffi.Int32()
+  external int track;
+  @ffi.Int32()
+  external int index;
+}
+
+// Mirrors LoudnessStats in src/loudness.h (LUFS / LU)
+final class LoudnessStats extends ffi.Struct {
+  @ffi.Double()
+  external double momentary;
+  @ffi.Double()
+  external double shortTerm;
+  @ffi.Double()
+  external double integrated;
+  @ffi.Double()
+  external double range;
+  @ffi.Double()
+  external double maxMomentary;
+  @ffi.Double()
+  external double maxShortTerm;
+  @ffi.Double()
+  external double duration;
+}
+
+// Mirrors SpectralDescriptors in src/descriptors.h
+final class SpectralDescriptors extends ffi.Struct {
+  @ffi.Float()
+  external double centroid;
+  @ffi.Float()
+  external double rolloff;
+  @ffi.Float()
+  external double flatness;
+  @ffi.Float()
+  external double flux;
+  @ffi.Float()
+  external double crest;
+}
+
+// Mirrors OnsetEvent in src/onset.h
+final class OnsetEvent extends ffi.Struct {
+  @ffi.Uint64()
+  external int frame;
+  @ffi.Double()
+  external double time;
+  @ffi.Float()
+  external double strength;
+  @ffi.Float()
+  external double threshold;
+}
+
+// Mirrors TempoStats in src/tempo.h (seconds on the media clock)
+final class TempoStats extends ffi.Struct {
+  @ffi.Double()
+  external double bpm;
+  @ffi.Double()
+  external double confidence;
+  @ffi.Double()
+  external double period;
+  @ffi.Double()
+  external double lastBeat;
+  @ffi.Double()
+  external double nextBeat;
+  @ffi.Double()
+  external double phase;
+}
+
+// Mirrors PitchEstimate in src/pitch.h
+final class PitchEstimate extends ffi.Struct {
+  @ffi.Float()
+  external double frequency;
+  @ffi.Float()
+  external double confidence;
+  @ffi.Float()
+  external double note;
+}
+
+// Mirrors PeakStats in src/true_peak.h (dBFS / dBTP)
+final class PeakStats extends ffi.Struct {
+  @ffi.Double()
+  external double samplePeak;
+  @ffi.Double()
+  external double truePeak;
+  @ffi.Double()
+  external double samplePeakHold;
+  @ffi.Double()
+  external double truePeakHold;
+  @ffi.Double()
+  external double maxSamplePeak;
+  @ffi.Double()
+  external double maxTruePeak;
+}
+
+// Mirrors ClockSyncStats in src/clock_sync.h
+final class ClockSyncStats extends ffi.Struct {
+  @ffi.Double()
+  external double errorSeconds;
+  @ffi.Double()
+  external double driftPpm;
+  @ffi.Double()
+  external double ratio;
+  @ffi.Int32()
+  external int locked;
+  @ffi.Int32()
+  external int resyncNeeded;
+}
+
+// Mirrors DspCommand in src/engine.h
+final class DspCommand extends ffi.Struct {
+  @ffi.Int32()
+  external int type;
+  @ffi.Uint64()
+  external int frame;
+  @ffi.Double()
+  external double value;
+}
+
+// DspCommand.type values (CommandType in src/engine.h)
+class DspCommandType {
+  static const int setGain = 0;
+  static const int seek = 1;         // value: seconds
+  static const int setDcBlocker = 2; // value: pole, e.g. 0.995
+  static const int resetLoudness = 4; // Restarts integrated loudness and LRA
+  static const int resetPeaks = 5;    // Clears peak holds and maxima
+}
+
+// Mirrors StartReport in src/engine.h
+final class StartReport extends ffi.Struct {
+  @ffi.Uint32()
+  external int ticket;
+  @ffi.Int32()
+  external int state;
+  @ffi.Int32()
+  external int error;
+  @ffi.Int32()
+  external int backendResult;
+  @ffi.Double()
+  external double decoderOpenMs;
+  @ffi.Double()
+  external double deviceInitMs;
+  @ffi.Double()
+  external double deviceStartMs;
+  @ffi.Double()
+  external double totalMs;
+}
+
+// Mirrors struct SpectrogramView in src/spectrogram.h
+final class SpectrogramView extends ffi.Struct {
+  external ffi.Pointer<ffi.Uint8> pixels;
+  @ffi.Int32()
+  external int width;
+  @ffi.Int32()
+  external int height;
+  @ffi.Int32()
+  external int headColumn;
+  @ffi.Int32()
+  external int updatedColumns;
+  @ffi.Uint64()
+  external int frame;
+}
+
+// Built-in waterfall colormaps (SpectrogramColormap in src/spectrogram.h)
+class SpectrogramColormap {
+  static const int gray = 0;
+  static const int inferno = 1;
+}
+
+// StartReport.state values (StartState in src/engine.h)
+class StartState {
+  static const int failed = -1;
+  static const int idle = 0;
+  static const int starting = 1;
+  static const int running = 2;
+}
+
+// StartReport.error values and DspInstance.start() results (StartError in src/engine.h)
+class StartError {
+  static const int none = 0;
+  static const int noFile = 1;
+  static const int decoderFailed = 2;
+  static const int resamplerFailed = 3;
+  static const int deviceInitFailed = 4;
+  static const int deviceStartFailed = 5;
+  static const int alreadyRunning = 6;
+  static const int cancelled = 7;
+  static const int invalidHandle = 8;
+}
+
+// Dart-side copy of an upcoming cue, safe to keep across frames
+class UpcomingCue {
+  final int index;
+  final double startTime;
+  final double endTime;
+  final String text;
+
+  const UpcomingCue(this.index, this.startTime, this.endTime, this.text);
+}
+
 // --- C++ Signatures (Updated) ---
 // الان init_engine دو ورودی دارد: Mode (int) و Path (char*)
 typedef InitEngineNative = ffi.Void Function(ffi.Int32 mode, ffi.Pointer<Utf8> path);
@@ -10,27 +228,196 @@ typedef InitEngineDart = void Function(int mode, ffi.Pointer<Utf8> path);
 typedef StopEngineNative = ffi.Void Function();
 typedef StopEngineDart = void Function();
 
+typedef ResumeEngineNative = ffi.Int32 Function();
+typedef ResumeEngineDart = int Function();
+
+typedef ResetMeterNative = ffi.Int32 Function();
+typedef ResetMeterDart = int Function();
+
 typedef GetRmsNative = ffi.Float Function();
 typedef GetRmsDart = double Function();
 
 typedef GetFftNative = ffi.Pointer<ffi.Float> Function();
 typedef GetFftDart = ffi.Pointer<ffi.Float> Function();
 
+typedef GetSpectrumBandsNative = ffi.Int32 Function(ffi.Pointer<ffi.Float> out, ffi.Int32 count,
+    ffi.Float minHz, ffi.Float maxHz, ffi.Float floorDb, ffi.Float ceilDb);
+typedef GetSpectrumBandsDart = int Function(ffi.Pointer<ffi.Float> out, int count,
+    double minHz, double maxHz, double floorDb, double ceilDb);
+
 typedef SetGainNative = ffi.Void Function(ffi.Float gain);
 typedef SetGainDart = void Function(double gain);
 
 typedef LoadSubtitlesNative = ffi.Void Function(ffi.Pointer<Utf8> data);
 typedef LoadSubtitlesDart = void Function(ffi.Pointer<Utf8> data);
 
+typedef LoadSubtitlesFileNative = ffi.Void Function(ffi.Pointer<Utf8> path);
+typedef LoadSubtitlesFileDart = void Function(ffi.Pointer<Utf8> path);
+
+typedef GetSubLoadStatusNative = ffi.Int32 Function();
+typedef GetSubLoadStatusDart = int Function();
+
 typedef GetSubIdxNative = ffi.Int32 Function();
 typedef GetSubIdxDart = int Function();
 
+typedef GetActiveSubsNative = ffi.Int32 Function(ffi.Pointer<ffi.Int32> out, ffi.Int32 capacity);
+typedef GetActiveSubsDart = int Function(ffi.Pointer<ffi.Int32> out, int capacity);
+
 typedef GetSubTextNative = ffi.Pointer<Utf8> Function(ffi.Int32 index);
 typedef GetSubTextDart = ffi.Pointer<Utf8> Function(int index);
 
+typedef GetSubCueNative = ffi.Int32 Function(ffi.Int32 index, ffi.Pointer<SubtitleCueInfo> out);
+typedef GetSubCueDart = int Function(int index, ffi.Pointer<SubtitleCueInfo> out);
+
+typedef GetSubStyleNameNative = ffi.Pointer<Utf8> Function(ffi.Int32 styleId);
+typedef GetSubStyleNameDart = ffi.Pointer<Utf8> Function(int styleId);
+
+typedef GetSubLookaheadNative = ffi.Int32 Function(ffi.Int32 track, ffi.Pointer<SubtitleCueInfo> out, ffi.Int32 count);
+typedef GetSubLookaheadDart = int Function(int track, ffi.Pointer<SubtitleCueInfo> out, int count);
+
+// Multi-track subtitles (track 0 is the default track)
+typedef OpenTrackNative = ffi.Int32 Function();
+typedef OpenTrackDart = int Function();
+
+typedef CloseTrackNative = ffi.Void Function(ffi.Int32 track);
+typedef CloseTrackDart = void Function(int track);
+
+typedef LoadTrackNative = ffi.Void Function(ffi.Int32 track, ffi.Pointer<Utf8> data);
+typedef LoadTrackDart = void Function(int track, ffi.Pointer<Utf8> data);
+
+typedef GetTrackLoadStatusNative = ffi.Int32 Function(ffi.Int32 track);
+typedef GetTrackLoadStatusDart = int Function(int track);
+
+typedef GetTrackActiveSubsNative = ffi.Int32 Function(ffi.Int32 track, ffi.Pointer<ffi.Int32> out, ffi.Int32 capacity);
+typedef GetTrackActiveSubsDart = int Function(int track, ffi.Pointer<ffi.Int32> out, int capacity);
+
+typedef GetTrackSubTextNative = ffi.Pointer<Utf8> Function(ffi.Int32 track, ffi.Int32 index);
+typedef GetTrackSubTextDart = ffi.Pointer<Utf8> Function(int track, int index);
+
+typedef GetTrackSubCueNative = ffi.Int32 Function(ffi.Int32 track, ffi.Int32 index, ffi.Pointer<SubtitleCueInfo> out);
+typedef GetTrackSubCueDart = int Function(int track, int index, ffi.Pointer<SubtitleCueInfo> out);
+
+typedef AppendTrackNative = ffi.Int32 Function(ffi.Int32 track, ffi.Pointer<Utf8> data);
+typedef AppendTrackDart = int Function(int track, ffi.Pointer<Utf8> data);
+
+typedef AmendTrackLastNative = ffi.Int32 Function(ffi.Int32 track, ffi.Double endTime, ffi.Pointer<Utf8> text);
+typedef AmendTrackLastDart = int Function(int track, double endTime, ffi.Pointer<Utf8> text);
+
+typedef GetAllActiveSubsNative = ffi.Int32 Function(ffi.Pointer<SubtitleActiveEntry> out, ffi.Int32 capacity);
+typedef GetAllActiveSubsDart = int Function(ffi.Pointer<SubtitleActiveEntry> out, int capacity);
+
+typedef GetSubGenerationNative = ffi.Uint32 Function();
+typedef GetSubGenerationDart = int Function();
+
 typedef GetTimeNative = ffi.Double Function();
 typedef GetTimeDart = double Function();
 
+typedef SetLatencyNative = ffi.Void Function(ffi.Double seconds);
+typedef SetLatencyDart = void Function(double seconds);
+
+// External video clock slaving
+typedef FeedVideoClockNative = ffi.Void Function(ffi.Double pts);
+typedef FeedVideoClockDart = void Function(double pts);
+
+typedef SetSlavingNative = ffi.Void Function(ffi.Int32 enabled);
+typedef SetSlavingDart = void Function(int enabled);
+
+typedef GetClockSyncStatsNative = ffi.Int32 Function(ffi.Pointer<ClockSyncStats> out);
+typedef GetClockSyncStatsDart = int Function(ffi.Pointer<ClockSyncStats> out);
+
+typedef GetLoudnessNative = ffi.Int32 Function(ffi.Pointer<LoudnessStats> out);
+typedef GetLoudnessDart = int Function(ffi.Pointer<LoudnessStats> out);
+typedef GetPeaksNative = ffi.Int32 Function(ffi.Pointer<PeakStats> out);
+typedef GetPeaksDart = int Function(ffi.Pointer<PeakStats> out);
+
+// Handle API: independent engines in one process
+typedef DspCreateNative = ffi.Int32 Function();
+typedef DspCreateDart = int Function();
+
+typedef DspHandleNative = ffi.Void Function(ffi.Int32 handle);
+typedef DspHandleDart = void Function(int handle);
+
+typedef DspResumeNative = ffi.Int32 Function(ffi.Int32 handle);
+typedef DspResumeDart = int Function(int handle);
+
+typedef DspStartNative = ffi.Int32 Function(ffi.Int32 handle, ffi.Int32 mode, ffi.Pointer<Utf8> path);
+typedef DspStartDart = int Function(int handle, int mode, ffi.Pointer<Utf8> path);
+
+typedef DspGetFloatNative = ffi.Float Function(ffi.Int32 handle);
+typedef DspGetFloatDart = double Function(int handle);
+
+typedef DspGetFftNative = ffi.Pointer<ffi.Float> Function(ffi.Int32 handle);
+typedef DspGetFftDart = ffi.Pointer<ffi.Float> Function(int handle);
+
+typedef GetMelFeaturesNative = ffi.Uint64 Function(ffi.Pointer<ffi.Float> mel, ffi.Pointer<ffi.Float> mfcc);
+typedef GetMelFeaturesDart = int Function(ffi.Pointer<ffi.Float> mel, ffi.Pointer<ffi.Float> mfcc);
+typedef GetSpectralDescriptorsNative = ffi.Uint64 Function(ffi.Pointer<SpectralDescriptors> out);
+typedef GetSpectralDescriptorsDart = int Function(ffi.Pointer<SpectralDescriptors> out);
+typedef DrainOnsetsNative = ffi.Int32 Function(ffi.Pointer<OnsetEvent> out, ffi.Int32 capacity);
+typedef DrainOnsetsDart = int Function(ffi.Pointer<OnsetEvent> out, int capacity);
+typedef GetTempoNative = ffi.Int32 Function(ffi.Pointer<TempoStats> out);
+typedef GetTempoDart = int Function(ffi.Pointer<TempoStats> out);
+typedef GetPitchNative = ffi.Uint64 Function(ffi.Pointer<PitchEstimate> out);
+typedef GetPitchDart = int Function(ffi.Pointer<PitchEstimate> out);
+
+typedef GetChromaNative = ffi.Uint64 Function(ffi.Pointer<ffi.Float> out);
+typedef GetChromaDart = int Function(ffi.Pointer<ffi.Float> out);
+
+typedef GetKeyNative = ffi.Int32 Function(ffi.Pointer<ffi.Float> confidence);
+typedef GetKeyDart = int Function(ffi.Pointer<ffi.Float> confidence);
+
+typedef ConfigureConstantQNative = ffi.Int32 Function(ffi.Int32 binsPerOctave, ffi.Float minHz, ffi.Float maxHz);
+typedef ConfigureConstantQDart = int Function(int binsPerOctave, double minHz, double maxHz);
+
+typedef GetConstantQNative = ffi.Int32 Function(ffi.Pointer<ffi.Float> out, ffi.Int32 capacity, ffi.Float floorDb, ffi.Float ceilDb);
+typedef GetConstantQDart = int Function(ffi.Pointer<ffi.Float> out, int capacity, double floorDb, double ceilDb);
+
+typedef ConfigureSpectrogramNative = ffi.Int32 Function(ffi.Int32 columns, ffi.Int32 rows, ffi.Float minHz, ffi.Float maxHz);
+typedef ConfigureSpectrogramDart = int Function(int columns, int rows, double minHz, double maxHz);
+
+typedef SetSpectrogramColormapNative = ffi.Void Function(ffi.Int32 colormap, ffi.Float floorDb, ffi.Float ceilDb);
+typedef SetSpectrogramColormapDart = void Function(int colormap, double floorDb, double ceilDb);
+
+typedef GetSpectrogramNative = ffi.Int32 Function(ffi.Pointer<SpectrogramView> out);
+typedef GetSpectrogramDart = int Function(ffi.Pointer<SpectrogramView> out);
+
+typedef DspGetSpectrumBandsNative = ffi.Int32 Function(ffi.Int32 handle, ffi.Pointer<ffi.Float> out,
+    ffi.Int32 count, ffi.Float minHz, ffi.Float maxHz, ffi.Float floorDb, ffi.Float ceilDb);
+typedef DspGetSpectrumBandsDart = int Function(int handle, ffi.Pointer<ffi.Float> out,
+    int count, double minHz, double maxHz, double floorDb, double ceilDb);
+
+typedef DspSetGainNative = ffi.Void Function(ffi.Int32 handle, ffi.Float gain);
+typedef DspSetGainDart = void Function(int handle, double gain);
+
+typedef DspGetTimeNative = ffi.Double Function(ffi.Int32 handle);
+typedef DspGetTimeDart = double Function(int handle);
+
+typedef DspLoadSubtitlesNative = ffi.Void Function(ffi.Int32 handle, ffi.Int32 track, ffi.Pointer<Utf8> data);
+typedef DspLoadSubtitlesDart = void Function(int handle, int track, ffi.Pointer<Utf8> data);
+
+// Asynchronous start
+typedef StartAsyncNative = ffi.Uint32 Function(ffi.Int32 mode, ffi.Pointer<Utf8> path);
+typedef StartAsyncDart = int Function(int mode, ffi.Pointer<Utf8> path);
+
+typedef GetStartReportNative = ffi.Int32 Function(ffi.Pointer<StartReport> out);
+typedef GetStartReportDart = int Function(ffi.Pointer<StartReport> out);
+
+// Sample-accurate commands
+typedef DspSubmitCommandsNative = ffi.Int32 Function(ffi.Int32 handle, ffi.Pointer<DspCommand> commands, ffi.Int32 count);
+typedef DspSubmitCommandsDart = int Function(int handle, ffi.Pointer<DspCommand> commands, int count);
+
+typedef DspGetFrameNative = ffi.Uint64 Function(ffi.Int32 handle);
+typedef DspGetFrameDart = int Function(int handle);
+
+typedef DspSeekNative = ffi.Int32 Function(ffi.Int32 handle, ffi.Double seconds);
+typedef DspSeekDart = int Function(int handle, double seconds);
+
+typedef DspSwitchSourceNative = ffi.Int32 Function(ffi.Int32 handle, ffi.Pointer<Utf8> path, ffi.Uint64 frame);
+typedef DspSwitchSourceDart = int Function(int handle, ffi.Pointer<Utf8> path, int frame);
+
+typedef SeekNative = ffi.Int32 Function(ffi.Double seconds);
+typedef SeekDart = int Function(double seconds);
+
 class DspBridge {
   static final DspBridge _instance = DspBridge._internal();
   factory DspBridge() => _instance;
@@ -39,13 +426,115 @@ class DspBridge {
   
   late final InitEngineDart _initEngineNative;
   late final StopEngineDart _stopEngineNative;
+  late final StopEngineDart _pauseEngineNative;
+  late final StartAsyncDart _startEngineAsyncNative;
+  late final GetStartReportDart _getStartReportNative;
+  late final ResumeEngineDart _resumeEngineNative;
   late final GetRmsDart _getRmsLevelNative;
   late final GetFftDart _getFftArrayNative;
+  late final GetSpectrumBandsDart _getSpectrumBandsNative;
+  late final GetMelFeaturesDart _getMelFeaturesNative;
+  late final GetSpectralDescriptorsDart _getSpectralDescriptorsNative;
+  late final DrainOnsetsDart _drainOnsetsNative;
+  late final GetTempoDart _getTempoNative;
+  late final GetPitchDart _getPitchNative;
+  late final GetChromaDart _getChromaNative;
+  late final GetKeyDart _getKeyNative;
+  late final ConfigureConstantQDart _configureConstantQNative;
+  late final GetConstantQDart _getConstantQNative;
+  late final ConfigureSpectrogramDart _configureSpectrogramNative;
+  late final SetSpectrogramColormapDart _setSpectrogramColormapNative;
+  late final GetSpectrogramDart _getSpectrogramNative;
   late final SetGainDart _setGainNative;
   late final LoadSubtitlesDart _loadSubtitlesNative;
+  late final LoadSubtitlesFileDart _loadSubtitlesFileNative;
+  late final GetSubLoadStatusDart _getSubtitleLoadStatusNative;
   late final GetSubIdxDart _getSubtitleIndexNative;
+  late final GetActiveSubsDart _getActiveSubtitlesNative;
   late final GetSubTextDart _getSubtitleTextNative;
+  late final GetSubCueDart _getSubtitleCueNative;
+  late final GetSubStyleNameDart _getSubtitleStyleNameNative;
+  late final OpenTrackDart _openSubtitleTrackNative;
+  late final CloseTrackDart _closeSubtitleTrackNative;
+  late final LoadTrackDart _loadTrackSubtitlesNative;
+  late final LoadTrackDart _loadTrackSubtitlesFileNative;
+  late final GetTrackLoadStatusDart _getTrackLoadStatusNative;
+  late final GetTrackActiveSubsDart _getTrackActiveSubtitlesNative;
+  late final GetTrackSubTextDart _getTrackSubtitleTextNative;
+  late final GetTrackSubCueDart _getTrackSubtitleCueNative;
+  late final AppendTrackDart _appendTrackSubtitlesNative;
+  late final AmendTrackLastDart _amendTrackLastSubtitleNative;
+  late final GetAllActiveSubsDart _getAllActiveSubtitlesNative;
+  late final GetSubLookaheadDart _getTrackSubtitleLookaheadNative;
+  late final GetSubGenerationDart _getSubtitleGenerationNative;
   late final GetTimeDart _getMediaTimeNative;
+  late final SetLatencyDart _setOutputLatencyNative;
+  late final GetTimeDart _getOutputLatencyNative;
+  late final FeedVideoClockDart _feedVideoClockNative;
+  late final SetSlavingDart _setVideoClockSlavingNative;
+  late final GetClockSyncStatsDart _getClockSyncStatsNative;
+  late final GetLoudnessDart _getLoudnessNative;
+  late final ResetMeterDart _resetLoudnessNative;
+  late final GetPeaksDart _getPeaksNative;
+  late final ResetMeterDart _resetPeaksNative;
+  late final DspCreateDart _dspCreateNative;
+  late final DspHandleDart _dspDestroyNative;
+  late final DspStartDart _dspStartNative;
+  late final DspHandleDart _dspStopNative;
+  late final DspHandleDart _dspPauseNative;
+  late final DspResumeDart _dspResumeNative;
+  late final DspGetFloatDart _dspGetRmsLevelNative;
+  late final DspGetFftDart _dspGetFftArrayNative;
+  late final DspGetSpectrumBandsDart _dspGetSpectrumBandsNative;
+  late final DspSetGainDart _dspSetGainNative;
+  late final DspGetTimeDart _dspGetMediaTimeNative;
+  late final DspLoadSubtitlesDart _dspLoadSubtitlesNative;
+  late final DspLoadSubtitlesDart _dspLoadSubtitlesFileNative;
+  late final DspSubmitCommandsDart _dspSubmitCommandsNative;
+  late final DspGetFrameDart _dspGetFramePositionNative;
+  late final DspSeekDart _dspSeekNative;
+  late final DspSwitchSourceDart _dspSwitchSourceNative;
+  late final SeekDart _seekEngineNative;
+
+  // Must match MAX_ACTIVE_SUBTITLES in subtitles.h
+  static const int maxActiveSubtitles = 8;
+  final ffi.Pointer<ffi.Int32> _activeSubtitlesBuffer = calloc<ffi.Int32>(maxActiveSubtitles);
+
+  // Must match MAX_SUBTITLE_TRACKS in subtitles.h
+  static const int maxSubtitleTracks = 8;
+  final ffi.Pointer<SubtitleActiveEntry> _activeEntriesBuffer =
+      calloc<SubtitleActiveEntry>(maxActiveSubtitles * maxSubtitleTracks);
+
+  static const int maxLookahead = 16;
+  final ffi.Pointer<SubtitleCueInfo> _lookaheadBuffer = calloc<SubtitleCueInfo>(maxLookahead);
+
+  final ffi.Pointer<ClockSyncStats> _clockSyncStatsBuffer = calloc<ClockSyncStats>();
+  final ffi.Pointer<LoudnessStats> _loudnessBuffer = calloc<LoudnessStats>();
+  final ffi.Pointer<PeakStats> _peaksBuffer = calloc<PeakStats>();
+  final ffi.Pointer<StartReport> _startReportBuffer = calloc<StartReport>();
+
+  // Must match MAX_SPECTRUM_BANDS in engine.h
+  static const int maxSpectrumBands = 512;
+  final ffi.Pointer<ffi.Float> _spectrumBandsBuffer = calloc<ffi.Float>(maxSpectrumBands);
+  // Must match MEL_BANDS / MFCC_COEFFS in engine.h
+  static const int melBands = 40;
+  static const int mfccCoeffs = 13;
+  final ffi.Pointer<ffi.Float> _melBuffer = calloc<ffi.Float>(melBands);
+  final ffi.Pointer<ffi.Float> _mfccBuffer = calloc<ffi.Float>(mfccCoeffs);
+  final ffi.Pointer<SpectralDescriptors> _descriptorBuffer = calloc<SpectralDescriptors>();
+  static const int maxOnsetsPerDrain = 64;
+  final ffi.Pointer<OnsetEvent> _onsetBuffer = calloc<OnsetEvent>(maxOnsetsPerDrain);
+  final ffi.Pointer<TempoStats> _tempoBuffer = calloc<TempoStats>();
+  final ffi.Pointer<PitchEstimate> _pitchBuffer = calloc<PitchEstimate>();
+  static const int pitchClasses = 12;
+  static const List<String> pitchClassNames = ['C', 'C#', 'D', 'D#', 'E', 'F', 'F#', 'G', 'G#', 'A', 'A#', 'B'];
+  final ffi.Pointer<ffi.Float> _chromaBuffer = calloc<ffi.Float>(pitchClasses);
+  final ffi.Pointer<ffi.Float> _keyConfidenceBuffer = calloc<ffi.Float>();
+
+  // Must match MAX_CQT_BINS in engine.h
+  static const int maxConstantQBins = 512;
+  final ffi.Pointer<ffi.Float> _constantQBuffer = calloc<ffi.Float>(maxConstantQBins);
+  final ffi.Pointer<SpectrogramView> _spectrogramViewBuffer = calloc<SpectrogramView>();
 
   DspBridge._internal() {
     _loadLibrary();
@@ -72,17 +561,90 @@ class DspBridge {
   void _bindSignatures() {
     _initEngineNative = _nativeLib.lookupFunction<InitEngineNative, InitEngineDart>('init_engine');
     _stopEngineNative = _nativeLib.lookupFunction<StopEngineNative, StopEngineDart>('stop_engine');
+    _pauseEngineNative = _nativeLib.lookupFunction<StopEngineNative, StopEngineDart>('pause_engine');
+    _startEngineAsyncNative = _nativeLib.lookupFunction<StartAsyncNative, StartAsyncDart>('start_engine_async');
+    _getStartReportNative = _nativeLib.lookupFunction<GetStartReportNative, GetStartReportDart>('get_start_report');
+    _resumeEngineNative = _nativeLib.lookupFunction<ResumeEngineNative, ResumeEngineDart>('resume_engine');
     _getRmsLevelNative = _nativeLib.lookupFunction<GetRmsNative, GetRmsDart>('get_rms_level');
     _getFftArrayNative = _nativeLib.lookupFunction<GetFftNative, GetFftDart>('get_fft_array');
+    _getSpectrumBandsNative = _nativeLib.lookupFunction<GetSpectrumBandsNative, GetSpectrumBandsDart>('get_spectrum_bands');
+    _getMelFeaturesNative = _nativeLib.lookupFunction<GetMelFeaturesNative, GetMelFeaturesDart>('get_mel_features');
+    _getSpectralDescriptorsNative = _nativeLib.lookupFunction<GetSpectralDescriptorsNative, GetSpectralDescriptorsDart>('get_spectral_descriptors');
+    _drainOnsetsNative = _nativeLib.lookupFunction<DrainOnsetsNative, DrainOnsetsDart>('drain_onsets');
+    _getTempoNative = _nativeLib.lookupFunction<GetTempoNative, GetTempoDart>('get_tempo');
+    _getPitchNative = _nativeLib.lookupFunction<GetPitchNative, GetPitchDart>('get_pitch');
+    _getChromaNative = _nativeLib.lookupFunction<GetChromaNative, GetChromaDart>('get_chroma');
+    _getKeyNative = _nativeLib.lookupFunction<GetKeyNative, GetKeyDart>('get_key');
+    _configureConstantQNative =
+        _nativeLib.lookupFunction<ConfigureConstantQNative, ConfigureConstantQDart>('configure_constant_q');
+    _getConstantQNative = _nativeLib.lookupFunction<GetConstantQNative, GetConstantQDart>('get_constant_q');
+    _configureSpectrogramNative =
+        _nativeLib.lookupFunction<ConfigureSpectrogramNative, ConfigureSpectrogramDart>('configure_spectrogram');
+    _setSpectrogramColormapNative =
+        _nativeLib.lookupFunction<SetSpectrogramColormapNative, SetSpectrogramColormapDart>('set_spectrogram_colormap');
+    _getSpectrogramNative = _nativeLib.lookupFunction<GetSpectrogramNative, GetSpectrogramDart>('get_spectrogram');
     _setGainNative = _nativeLib.lookupFunction<SetGainNative, SetGainDart>('set_gain');
     _loadSubtitlesNative = _nativeLib.lookupFunction<LoadSubtitlesNative, LoadSubtitlesDart>('load_subtitles');
+    _loadSubtitlesFileNative = _nativeLib.lookupFunction<LoadSubtitlesFileNative, LoadSubtitlesFileDart>('load_subtitles_file');
+    _getSubtitleLoadStatusNative = _nativeLib.lookupFunction<GetSubLoadStatusNative, GetSubLoadStatusDart>('get_subtitle_load_status');
     _getSubtitleIndexNative = _nativeLib.lookupFunction<GetSubIdxNative, GetSubIdxDart>('get_subtitle_index');
+    _getActiveSubtitlesNative = _nativeLib.lookupFunction<GetActiveSubsNative, GetActiveSubsDart>('get_active_subtitles');
     _getSubtitleTextNative = _nativeLib.lookupFunction<GetSubTextNative, GetSubTextDart>('get_subtitle_text');
+    _getSubtitleCueNative = _nativeLib.lookupFunction<GetSubCueNative, GetSubCueDart>('get_subtitle_cue');
+    _getSubtitleStyleNameNative = _nativeLib.lookupFunction<GetSubStyleNameNative, GetSubStyleNameDart>('get_subtitle_style_name');
+    _openSubtitleTrackNative = _nativeLib.lookupFunction<OpenTrackNative, OpenTrackDart>('open_subtitle_track');
+    _closeSubtitleTrackNative = _nativeLib.lookupFunction<CloseTrackNative, CloseTrackDart>('close_subtitle_track');
+    _loadTrackSubtitlesNative = _nativeLib.lookupFunction<LoadTrackNative, LoadTrackDart>('load_track_subtitles');
+    _loadTrackSubtitlesFileNative = _nativeLib.lookupFunction<LoadTrackNative, LoadTrackDart>('load_track_subtitles_file');
+    _getTrackLoadStatusNative = _nativeLib.lookupFunction<GetTrackLoadStatusNative, GetTrackLoadStatusDart>('get_track_load_status');
+    _getTrackActiveSubtitlesNative = _nativeLib.lookupFunction<GetTrackActiveSubsNative, GetTrackActiveSubsDart>('get_track_active_subtitles');
+    _getTrackSubtitleTextNative = _nativeLib.lookupFunction<GetTrackSubTextNative, GetTrackSubTextDart>('get_track_subtitle_text');
+    _getTrackSubtitleCueNative = _nativeLib.lookupFunction<GetTrackSubCueNative, GetTrackSubCueDart>('get_track_subtitle_cue');
+    _appendTrackSubtitlesNative = _nativeLib.lookupFunction<AppendTrackNative, AppendTrackDart>('append_track_subtitles');
+    _amendTrackLastSubtitleNative = _nativeLib.lookupFunction<AmendTrackLastNative, AmendTrackLastDart>('amend_track_last_subtitle');
+    _getAllActiveSubtitlesNative = _nativeLib.lookupFunction<GetAllActiveSubsNative, GetAllActiveSubsDart>('get_all_active_subtitles');
+    _getTrackSubtitleLookaheadNative = _nativeLib.lookupFunction<GetSubLookaheadNative, GetSubLookaheadDart>('get_track_subtitle_lookahead');
+    _getSubtitleGenerationNative = _nativeLib.lookupFunction<GetSubGenerationNative, GetSubGenerationDart>('get_subtitle_generation');
     _getMediaTimeNative = _nativeLib.lookupFunction<GetTimeNative, GetTimeDart>('get_media_time');
+    _setOutputLatencyNative = _nativeLib.lookupFunction<SetLatencyNative, SetLatencyDart>('set_output_latency');
+    _getOutputLatencyNative = _nativeLib.lookupFunction<GetTimeNative, GetTimeDart>('get_output_latency');
+    _feedVideoClockNative = _nativeLib.lookupFunction<FeedVideoClockNative, FeedVideoClockDart>('feed_video_clock');
+    _setVideoClockSlavingNative = _nativeLib.lookupFunction<SetSlavingNative, SetSlavingDart>('set_video_clock_slaving');
+    _getClockSyncStatsNative = _nativeLib.lookupFunction<GetClockSyncStatsNative, GetClockSyncStatsDart>('get_clock_sync_stats');
+    _getLoudnessNative = _nativeLib.lookupFunction<GetLoudnessNative, GetLoudnessDart>('get_loudness');
+    _resetLoudnessNative = _nativeLib.lookupFunction<ResetMeterNative, ResetMeterDart>('reset_loudness');
+    _getPeaksNative = _nativeLib.lookupFunction<GetPeaksNative, GetPeaksDart>('get_peaks');
+    _resetPeaksNative = _nativeLib.lookupFunction<ResetMeterNative, ResetMeterDart>('reset_peaks');
+    _dspCreateNative = _nativeLib.lookupFunction<DspCreateNative, DspCreateDart>('dsp_create');
+    _dspDestroyNative = _nativeLib.lookupFunction<DspHandleNative, DspHandleDart>('dsp_destroy');
+    _dspStartNative = _nativeLib.lookupFunction<DspStartNative, DspStartDart>('dsp_start');
+    _dspStopNative = _nativeLib.lookupFunction<DspHandleNative, DspHandleDart>('dsp_stop');
+    _dspPauseNative = _nativeLib.lookupFunction<DspHandleNative, DspHandleDart>('dsp_pause');
+    _dspResumeNative = _nativeLib.lookupFunction<DspResumeNative, DspResumeDart>('dsp_resume');
+    _dspGetRmsLevelNative = _nativeLib.lookupFunction<DspGetFloatNative, DspGetFloatDart>('dsp_get_rms_level');
+    _dspGetFftArrayNative = _nativeLib.lookupFunction<DspGetFftNative, DspGetFftDart>('dsp_get_fft_array');
+    _dspGetSpectrumBandsNative =
+        _nativeLib.lookupFunction<DspGetSpectrumBandsNative, DspGetSpectrumBandsDart>('dsp_get_spectrum_bands');
+    _dspSetGainNative = _nativeLib.lookupFunction<DspSetGainNative, DspSetGainDart>('dsp_set_gain');
+    _dspGetMediaTimeNative = _nativeLib.lookupFunction<DspGetTimeNative, DspGetTimeDart>('dsp_get_media_time');
+    _dspLoadSubtitlesNative = _nativeLib.lookupFunction<DspLoadSubtitlesNative, DspLoadSubtitlesDart>('dsp_load_subtitles');
+    _dspLoadSubtitlesFileNative = _nativeLib.lookupFunction<DspLoadSubtitlesNative, DspLoadSubtitlesDart>('dsp_load_subtitles_file');
+    _dspSubmitCommandsNative = _nativeLib.lookupFunction<DspSubmitCommandsNative, DspSubmitCommandsDart>('dsp_submit_commands');
+    _dspGetFramePositionNative = _nativeLib.lookupFunction<DspGetFrameNative, DspGetFrameDart>('dsp_get_frame_position');
+    _dspSeekNative = _nativeLib.lookupFunction<DspSeekNative, DspSeekDart>('dsp_seek');
+    _dspSwitchSourceNative = _nativeLib.lookupFunction<DspSwitchSourceNative, DspSwitchSourceDart>('dsp_switch_source');
+    _seekEngineNative = _nativeLib.lookupFunction<SeekNative, SeekDart>('seek_engine');
   }
 
   // --- PUBLIC API ---
 
+  // Creates an independent engine (e.g. a preview player next to the main
+  // one); null when the native pool is exhausted
+  DspInstance? createInstance() {
+    final handle = _dspCreateNative();
+    return handle > 0 ? DspInstance._(this, handle) : null;
+  }
+
   // Updated Init: Accepts mode and optional file path
   void initEngine({int mode = 0, String? filePath}) {
     final ptr = (filePath != null) ? filePath.toNativeUtf8() : ffi.nullptr;
@@ -92,22 +654,430 @@ class DspBridge {
     }
   }
   
+  // Same as initEngine, but decoder open and device init run on a native
+  // worker; returns a ticket, poll getStartReport() until it leaves STARTING
+  int startEngineAsync({int mode = 0, String? filePath}) {
+    final ptr = (filePath != null) ? filePath.toNativeUtf8() : ffi.nullptr;
+    final ticket = _startEngineAsyncNative(mode, ptr); // Path is copied natively
+    if (ptr != ffi.nullptr) {
+      calloc.free(ptr);
+    }
+    return ticket;
+  }
+
+  ({int ticket, int state, int error, int backendResult, double decoderOpenMs,
+    double deviceInitMs, double deviceStartMs, double totalMs})? getStartReport() {
+    if (_getStartReportNative(_startReportBuffer) == 0) return null;
+    final r = _startReportBuffer.ref;
+    return (
+      ticket: r.ticket,
+      state: r.state,
+      error: r.error,
+      backendResult: r.backendResult,
+      decoderOpenMs: r.decoderOpenMs,
+      deviceInitMs: r.deviceInitMs,
+      deviceStartMs: r.deviceStartMs,
+      totalMs: r.totalMs,
+    );
+  }
+
   void stopEngine() => _stopEngineNative();
+
+  // Stop/restart the stream without tearing down the device (sub-ms).
+  // resumeEngine() is false when the device would not restart.
+  void pauseEngine() => _pauseEngineNative();
+  bool resumeEngine() => _resumeEngineNative() != 0;
   double getRmsLevel() => _getRmsLevelNative();
   ffi.Pointer<ffi.Float> getFftArray() => _getFftArrayNative();
+
+  // `count` log-spaced bands, already in dB and normalized to 0..1 by the engine
+  List<double> getSpectrumBands(int count,
+      {double minHz = 30.0, double maxHz = 16000.0, double floorDb = -70.0, double ceilDb = 0.0}) {
+    final int n = _getSpectrumBandsNative(_spectrumBandsBuffer, count, minHz, maxHz, floorDb, ceilDb);
+    return List<double>.from(_spectrumBandsBuffer.asTypedList(n));
+  }
+
+  // Log-mel energies and MFCCs of the latest FFT hop; `hop` tells repeated
+  // polls apart (0 before the first hop)
+  ({int hop, List<double> mel, List<double> mfcc}) getMelFeatures() {
+    final int hop = _getMelFeaturesNative(_melBuffer, _mfccBuffer);
+    return (
+      hop: hop,
+      mel: List<double>.from(_melBuffer.asTypedList(melBands)),
+      mfcc: List<double>.from(_mfccBuffer.asTypedList(mfccCoeffs)),
+    );
+  }
+
+  // Per-hop spectral descriptors, computed on the audio thread right after
+  // the FFT. Centroid and rolloff in Hz; all zero for a silent hop.
+  ({int hop, double centroid, double rolloff, double flatness, double flux, double crest}) getSpectralDescriptors() {
+    final int hop = _getSpectralDescriptorsNative(_descriptorBuffer);
+    final d = _descriptorBuffer.ref;
+    return (
+      hop: hop,
+      centroid: d.centroid,
+      rolloff: d.rolloff,
+      flatness: d.flatness,
+      flux: d.flux,
+      crest: d.crest,
+    );
+  }
+
+  // Onsets detected since the last call, oldest first. Times are media-clock
+  // seconds of the attack itself; they arrive about one FFT hop late, so
+  // visuals can schedule against getMediaTime() instead of polling fast.
+  List<({int frame, double time, double strength})> drainOnsets() {
+    final events = <({int frame, double time, double strength})>[];
+    int n;
+    do {
+      n = _drainOnsetsNative(_onsetBuffer, maxOnsetsPerDrain);
+      for (int i = 0; i < n; i++) {
+        final e = _onsetBuffer[i];
+        events.add((frame: e.frame, time: e.time, strength: e.strength));
+      }
+    } while (n == maxOnsetsPerDrain);
+    return events;
+  }
+
+  // Tempo and beat grid. `phase` (0 on the beat) and `nextBeat` are taken
+  // against the media clock at the time of the call, so a 60 Hz poll still
+  // animates on the beat. Null until a tempo has been found.
+  ({double bpm, double confidence, double period, double lastBeat, double nextBeat, double phase})? getTempo() {
+    if (_getTempoNative(_tempoBuffer) == 0) return null;
+    final t = _tempoBuffer.ref;
+    if (t.bpm <= 0.0) return null;
+    return (
+      bpm: t.bpm,
+      confidence: t.confidence,
+      period: t.period,
+      lastBeat: t.lastBeat,
+      nextBeat: t.nextBeat,
+      phase: t.phase,
+    );
+  }
+
+  // Microphone pitch (capture mode), updated every 256 samples. `name` is
+  // the nearest note (e.g. 'A4') and `cents` the deviation from it; null
+  // while the input is silent or unvoiced.
+  ({int hop, double frequency, double confidence, int note, String name, double cents})? getPitch() {
+    final int hop = _getPitchNative(_pitchBuffer);
+    final p = _pitchBuffer.ref;
+    if (hop == 0 || p.frequency <= 0.0) return null;
+    final int note = p.note.round();
+    return (
+      hop: hop,
+      frequency: p.frequency,
+      confidence: p.confidence,
+      note: note,
+      name: '${pitchClassNames[note % 12]}${note ~/ 12 - 1}',
+      cents: (p.note - note) * 100.0,
+    );
+  }
+
+  // Smoothed chroma of the playing file (C first, loudest class = 1.0)
+  ({int hop, List<double> chroma}) getChroma() {
+    final int hop = _getChromaNative(_chromaBuffer);
+    return (hop: hop, chroma: List<double>.from(_chromaBuffer.asTypedList(pitchClasses)));
+  }
+
+  // Running key estimate: key 0..11 = C..B major, 12..23 = C..B minor,
+  // null until enough tonal material has played
+  ({int key, String name, double confidence})? getKey() {
+    final int key = _getKeyNative(_keyConfidenceBuffer);
+    if (key < 0) return null;
+    final String name = '${pitchClassNames[key % 12]} ${key < 12 ? 'major' : 'minor'}';
+    return (key: key, name: name, confidence: _keyConfidenceBuffer.value);
+  }
+
+  // Constant-Q bins from minHz, bin k at minHz * 2^(k / binsPerOctave).
+  // Returns the bin count, 0 when the range is invalid.
+  int configureConstantQ(int binsPerOctave, {double minHz = 55.0, double maxHz = 8000.0}) =>
+      _configureConstantQNative(binsPerOctave, minHz, maxHz);
+
+  // Constant-Q magnitudes of the newest 341 ms, normalized dB in 0..1
+  List<double> getConstantQ({double floorDb = -70.0, double ceilDb = 0.0}) {
+    final int n = _getConstantQNative(_constantQBuffer, maxConstantQBins, floorDb, ceilDb);
+    return List<double>.from(_constantQBuffer.asTypedList(n));
+  }
+
+  // Waterfall of the last `columns` spectra (up to 8192), `rows` log-spaced
+  // frequency rows. Recording starts with the first configure and restarts
+  // when a wider one outgrows the native history.
+  bool configureSpectrogram(int columns, int rows, {double minHz = 30.0, double maxHz = 16000.0}) =>
+      _configureSpectrogramNative(columns, rows, minHz, maxHz) != 0;
+
+  void setSpectrogramColormap(int colormap, {double floorDb = -90.0, double ceilDb = 0.0}) =>
+      _setSpectrogramColormapNative(colormap, floorDb, ceilDb);
+
+  // Draws the spectra that arrived since the last call and returns the RGBA8
+  // ring texture, ready for decodeImageFromPixels (which copies it). The
+  // image scrolls by drawing columns [headColumn, width) then [0, headColumn).
+  // `pixels` views native memory that the next call overwrites.
+  ({Uint8List pixels, int width, int height, int headColumn, int updatedColumns, int frame})? getSpectrogram() {
+    if (_getSpectrogramNative(_spectrogramViewBuffer) == 0) return null;
+    final v = _spectrogramViewBuffer.ref;
+    return (
+      pixels: v.pixels.asTypedList(v.width * v.height * 4),
+      width: v.width,
+      height: v.height,
+      headColumn: v.headColumn,
+      updatedColumns: v.updatedColumns,
+      frame: v.frame,
+    );
+  }
   void setGain(double gain) => _setGainNative(gain);
+  bool seek(double seconds) => _seekEngineNative(seconds) != 0;
   double getMediaTime() => _getMediaTimeNative();
+
+  // Override the device-reported output latency with a measured one (seconds);
+  // pass a negative value to go back to the reported latency
+  void setOutputLatency(double seconds) => _setOutputLatencyNative(seconds);
+  double getOutputLatency() => _getOutputLatencyNative();
+
+  // Slave the audio clock to the video: call with each frame's PTS (seconds)
+  // when it is presented. The first call after a start enables slaving,
+  // unless setVideoClockSlaving() chose otherwise.
+  void feedVideoClock(double pts) => _feedVideoClockNative(pts);
+  void setVideoClockSlaving(bool enabled) => _setVideoClockSlavingNative(enabled ? 1 : 0);
+
+  // Error (audio - video), drift estimate and lock state; resyncNeeded means
+  // the gap is too large to slew and the player should seek instead
+  ({double error, double driftPpm, double ratio, bool locked, bool resyncNeeded})? getClockSyncStats() {
+    if (_getClockSyncStatsNative(_clockSyncStatsBuffer) == 0) return null;
+    final s = _clockSyncStatsBuffer.ref;
+    return (
+      error: s.errorSeconds,
+      driftPpm: s.driftPpm,
+      ratio: s.ratio,
+      locked: s.locked != 0,
+      resyncNeeded: s.resyncNeeded != 0,
+    );
+  }
+
+  // EBU R128 meter, refreshed every 100 ms. Loudness values are
+  // double.negativeInfinity until their window has filled.
+  ({double momentary, double shortTerm, double integrated, double range,
+    double maxMomentary, double maxShortTerm, double duration})? getLoudness() {
+    if (_getLoudnessNative(_loudnessBuffer) == 0) return null;
+    final s = _loudnessBuffer.ref;
+    return (
+      momentary: s.momentary,
+      shortTerm: s.shortTerm,
+      integrated: s.integrated,
+      range: s.range,
+      maxMomentary: s.maxMomentary,
+      maxShortTerm: s.maxShortTerm,
+      duration: s.duration,
+    );
+  }
+
+  // False when the native command queue is full; retry on a later frame
+  bool resetLoudness() => _resetLoudnessNative() != 0;
+
+  // Sample and 4x-oversampled true peak, published once per audio callback.
+  // Display values fall at 20 dB / 1.7 s after a 2 s hold; all in dB and
+  // double.negativeInfinity while silent.
+  ({double samplePeak, double truePeak, double samplePeakHold, double truePeakHold,
+    double maxSamplePeak, double maxTruePeak})? getPeaks() {
+    if (_getPeaksNative(_peaksBuffer) == 0) return null;
+    final s = _peaksBuffer.ref;
+    return (
+      samplePeak: s.samplePeak,
+      truePeak: s.truePeak,
+      samplePeakHold: s.samplePeakHold,
+      truePeakHold: s.truePeakHold,
+      maxSamplePeak: s.maxSamplePeak,
+      maxTruePeak: s.maxTruePeak,
+    );
+  }
+
+  bool resetPeaks() => _resetPeaksNative() != 0;
   int getSubtitleIndex() => _getSubtitleIndexNative();
 
-  void loadSubtitles(String srtContent) {
-    final ptr = srtContent.toNativeUtf8();
+  // All cues active right now (overlapping dialogue, signs, ...), ascending
+  List<int> getActiveSubtitles() {
+    final count = _getActiveSubtitlesNative(_activeSubtitlesBuffer, maxActiveSubtitles);
+    final n = count < maxActiveSubtitles ? count : maxActiveSubtitles;
+    return List<int>.generate(n, (i) => _activeSubtitlesBuffer[i]);
+  }
+
+  // Accepts SRT, WebVTT or ASS/SSA; the format is detected natively
+  void loadSubtitles(String content) {
+    final ptr = content.toNativeUtf8();
     _loadSubtitlesNative(ptr);
     calloc.free(ptr);
   }
 
+  // Maps and parses the file on a native worker; poll getSubtitleLoadStatus()
+  void loadSubtitlesFile(String path) {
+    final ptr = path.toNativeUtf8();
+    _loadSubtitlesFileNative(ptr);
+    calloc.free(ptr);
+  }
+
+  // -1 failed, 0 idle, 1 loading, 2 ready
+  int getSubtitleLoadStatus() => _getSubtitleLoadStatusNative();
+
   String getSubtitleText(int index) {
     final ptr = _getSubtitleTextNative(index);
     if (ptr == ffi.nullptr) return "";
     return ptr.toDartString();
   }
-}
\ No newline at end of file
+
+  // Fills `out` with cue timing, ASS layer/style and text; false if out of range
+  bool getSubtitleCue(int index, ffi.Pointer<SubtitleCueInfo> out) =>
+      _getSubtitleCueNative(index, out) != 0;
+
+  String getSubtitleStyleName(int styleId) {
+    final ptr = _getSubtitleStyleNameNative(styleId);
+    if (ptr == ffi.nullptr) return "";
+    return ptr.toDartString();
+  }
+
+  // --- Subtitle Tracks ---
+  // Returns a track handle, or -1 when all tracks are in use
+  int openSubtitleTrack() => _openSubtitleTrackNative();
+  void closeSubtitleTrack(int track) => _closeSubtitleTrackNative(track);
+
+  void loadTrackSubtitles(int track, String content) {
+    final ptr = content.toNativeUtf8();
+    _loadTrackSubtitlesNative(track, ptr);
+    calloc.free(ptr);
+  }
+
+  void loadTrackSubtitlesFile(int track, String path) {
+    final ptr = path.toNativeUtf8();
+    _loadTrackSubtitlesFileNative(track, ptr);
+    calloc.free(ptr);
+  }
+
+  // Live captions: appends cue fragments (SRT/WebVTT/ASS) to the track's
+  // append-only store; existing indices stay valid. Returns cues appended.
+  int appendTrackSubtitles(int track, String fragment) {
+    final ptr = fragment.toNativeUtf8();
+    final appended = _appendTrackSubtitlesNative(track, ptr);
+    calloc.free(ptr);
+    return appended;
+  }
+
+  // Updates the newest live cue in place; omitted fields are kept
+  bool amendTrackLastSubtitle(int track, {double? endTime, String? text}) {
+    final ptr = (text != null) ? text.toNativeUtf8() : ffi.nullptr;
+    final ok = _amendTrackLastSubtitleNative(track, endTime ?? -1.0, ptr) != 0;
+    if (ptr != ffi.nullptr) {
+      calloc.free(ptr);
+    }
+    return ok;
+  }
+
+  int getTrackLoadStatus(int track) => _getTrackLoadStatusNative(track);
+
+  List<int> getTrackActiveSubtitles(int track) {
+    final count = _getTrackActiveSubtitlesNative(track, _activeSubtitlesBuffer, maxActiveSubtitles);
+    final n = count < maxActiveSubtitles ? count : maxActiveSubtitles;
+    return List<int>.generate(n, (i) => _activeSubtitlesBuffer[i]);
+  }
+
+  String getTrackSubtitleText(int track, int index) {
+    final ptr = _getTrackSubtitleTextNative(track, index);
+    if (ptr == ffi.nullptr) return "";
+    return ptr.toDartString();
+  }
+
+  bool getTrackSubtitleCue(int track, int index, ffi.Pointer<SubtitleCueInfo> out) =>
+      _getTrackSubtitleCueNative(track, index, out) != 0;
+
+  // Bumped whenever any track's active set changes; poll this first
+  int getSubtitleGeneration() => _getSubtitleGenerationNative();
+
+  // Active cues of every open track in one call, as (track, index) pairs
+  List<(int, int)> getAllActiveSubtitles() {
+    final n = _getAllActiveSubtitlesNative(_activeEntriesBuffer, maxActiveSubtitles * maxSubtitleTracks);
+    return List<(int, int)>.generate(n, (i) => (_activeEntriesBuffer[i].track, _activeEntriesBuffer[i].index));
+  }
+
+  // Next cues after the current media time, so text can be laid out before it shows
+  List<UpcomingCue> getSubtitleLookahead({int track = 0, int count = 4}) {
+    final n = _getTrackSubtitleLookaheadNative(
+        track, _lookaheadBuffer, count < maxLookahead ? count : maxLookahead);
+    return List<UpcomingCue>.generate(n, (i) {
+      final cue = _lookaheadBuffer[i];
+      return UpcomingCue(cue.index, cue.startTime, cue.endTime,
+          cue.text.toDartString(length: cue.textLength));
+    });
+  }
+}
+
+// One engine of the handle API. Calls after dispose() are ignored natively.
+class DspInstance {
+  final DspBridge _bridge;
+  final int handle;
+
+  DspInstance._(this._bridge, this.handle);
+
+  // Returns a StartError value; StartError.invalidHandle after dispose()
+  int start({int mode = 0, String? filePath}) {
+    final ptr = (filePath != null) ? filePath.toNativeUtf8() : ffi.nullptr;
+    final error = _bridge._dspStartNative(handle, mode, ptr);
+    if (ptr != ffi.nullptr) {
+      calloc.free(ptr);
+    }
+    return error;
+  }
+
+  void stop() => _bridge._dspStopNative(handle);
+  void pause() => _bridge._dspPauseNative(handle);
+  bool resume() => _bridge._dspResumeNative(handle) != 0;
+  void dispose() => _bridge._dspDestroyNative(handle);
+  double getRmsLevel() => _bridge._dspGetRmsLevelNative(handle);
+  ffi.Pointer<ffi.Float> getFftArray() => _bridge._dspGetFftArrayNative(handle);
+
+  List<double> getSpectrumBands(int count,
+      {double minHz = 30.0, double maxHz = 16000.0, double floorDb = -70.0, double ceilDb = 0.0}) {
+    final ptr = _bridge._spectrumBandsBuffer;
+    final int n = _bridge._dspGetSpectrumBandsNative(handle, ptr, count, minHz, maxHz, floorDb, ceilDb);
+    return List<double>.from(ptr.asTypedList(n));
+  }
+  void setGain(double gain) => _bridge._dspSetGainNative(handle, gain);
+  bool seek(double seconds) => _bridge._dspSeekNative(handle, seconds) != 0;
+
+  // Engine frame the next callback starts at; add a lead to schedule commands
+  int getFramePosition() => _bridge._dspGetFramePositionNative(handle);
+
+  // Applies the batch atomically on the audio thread, each command at its
+  // frame (0 = next callback). False when the native queue is full.
+  bool submitCommands(List<({int type, int frame, double value})> commands) {
+    if (commands.isEmpty) return true;
+    final ptr = calloc<DspCommand>(commands.length);
+    for (var i = 0; i < commands.length; i++) {
+      ptr[i]
+        ..type = commands[i].type
+        ..frame = commands[i].frame
+        ..value = commands[i].value;
+    }
+    final ok = _bridge._dspSubmitCommandsNative(handle, ptr, commands.length) != 0;
+    calloc.free(ptr);
+    return ok;
+  }
+
+  // Opens the file here, then swaps it in on the audio thread at `frame`
+  bool switchSource(String filePath, {int frame = 0}) {
+    final ptr = filePath.toNativeUtf8();
+    final ok = _bridge._dspSwitchSourceNative(handle, ptr, frame) != 0;
+    calloc.free(ptr);
+    return ok;
+  }
+  double getMediaTime() => _bridge._dspGetMediaTimeNative(handle);
+
+  void loadSubtitles(String content, {int track = 0}) {
+    final ptr = content.toNativeUtf8();
+    _bridge._dspLoadSubtitlesNative(handle, track, ptr);
+    calloc.free(ptr);
+  }
+
+  void loadSubtitlesFile(String path, {int track = 0}) {
+    final ptr = path.toNativeUtf8();
+    _bridge._dspLoadSubtitlesFileNative(handle, track, ptr);
+    calloc.free(ptr);
+  }
+}
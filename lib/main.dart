@@ -124,19 +124,19 @@ class DspControlPanel extends StatelessWidget {
                 ),
                 const SizedBox(height: 30),
 
-                // --- 3. Visualizer (FFT + RMS) ---
+                // --- 3. Visualizer (FFT + True Peak) ---
                 CyberContainer(
                   primaryColor: primaryColor,
                   padding: const EdgeInsets.all(16),
                   child: Column(
                     children: [
-                      _buildRmsMeter(context, state.rmsLevel, primaryColor),
+                      _buildPeakMeter(context, state.truePeak, state.truePeakHold, primaryColor),
                       const SizedBox(height: 20),
                       SizedBox(
                         height: 180,
                         width: double.infinity,
                         child: CustomPaint(
-                          painter: SpectrumPainter(state.fftData, primaryColor),
+                          painter: SpectrumPainter(state.spectrumBands, primaryColor),
                         ),
                       ),
                     ],
@@ -231,10 +231,13 @@ class DspControlPanel extends StatelessWidget {
     );
   }
 
-  Widget _buildRmsMeter(BuildContext context, double rawRms, Color color) {
-    // Convert to dB
-    final double db = rawRms > 0.00001 ? 20 * math.log(rawRms) / math.ln10 : -100.0;
-    final double normalized = ((db + 60) / 60).clamp(0.0, 1.0); // range -60dB to 0dB
+  Widget _buildPeakMeter(BuildContext context, double peakDb, double holdDb, Color color) {
+    // True peak (dBTP) with ballistics from C++; range -60dB to 0dB
+    double toFraction(double db) => db.isFinite ? ((db + 60) / 60).clamp(0.0, 1.0) : 0.0;
+    final double normalized = toFraction(peakDb);
+    final double hold = toFraction(holdDb);
+    final String label = holdDb.isFinite ? "${holdDb.toStringAsFixed(1)} dBTP" : "-inf dBTP";
+    final Color labelColor = holdDb > 0.0 ? Colors.redAccent : Colors.white70;
 
     return Column(
       crossAxisAlignment: CrossAxisAlignment.stretch,
@@ -243,7 +246,7 @@ class DspControlPanel extends StatelessWidget {
           mainAxisAlignment: MainAxisAlignment.spaceBetween,
           children: [
             const Text("MASTER OUTPUT", style: TextStyle(fontSize: 10, color: Colors.white38)),
-            Text("${db.toStringAsFixed(1)} dB", style: const TextStyle(fontSize: 10, color: Colors.white70)),
+            Text(label, style: TextStyle(fontSize: 10, color: labelColor)),
           ],
         ),
         const SizedBox(height: 5),
@@ -254,16 +257,25 @@ class DspControlPanel extends StatelessWidget {
             borderRadius: BorderRadius.circular(2),
             border: Border.all(color: Colors.white10),
           ),
-          child: FractionallySizedBox(
-            alignment: Alignment.centerLeft,
-            widthFactor: normalized,
-            child: Container(
-              decoration: BoxDecoration(
-                color: color,
-                borderRadius: BorderRadius.circular(1),
-                boxShadow: [BoxShadow(color: color.withOpacity(0.5), blurRadius: 6)],
+          child: Stack(
+            children: [
+              FractionallySizedBox(
+                alignment: Alignment.centerLeft,
+                widthFactor: normalized,
+                child: Container(
+                  decoration: BoxDecoration(
+                    color: color,
+                    borderRadius: BorderRadius.circular(1),
+                    boxShadow: [BoxShadow(color: color.withOpacity(0.5), blurRadius: 6)],
+                  ),
+                ),
               ),
-            ),
+              // Peak-hold marker
+              Align(
+                alignment: Alignment(hold * 2 - 1, 0),
+                child: Container(width: 2, color: hold > 0 ? Colors.white : Colors.transparent),
+              ),
+            ],
           ),
         ),
       ],
@@ -304,35 +316,31 @@ class CyberContainer extends StatelessWidget {
   }
 }
 
-// --- FFT Painter ---
+// --- Spectrum Painter ---
+// Bands arrive log-spaced and normalized to 0..1 by the engine
 class SpectrumPainter extends CustomPainter {
-  final List<double> fftData;
+  final List<double> bands;
   final Color color;
 
-  SpectrumPainter(this.fftData, this.color);
+  SpectrumPainter(this.bands, this.color);
 
   @override
   void paint(Canvas canvas, Size size) {
-    if (fftData.isEmpty) return;
+    if (bands.isEmpty) return;
+
+    final int count = bands.length;
+    final double barWidth = size.width / count;
 
     final paint = Paint()
       ..color = color
-      ..strokeWidth = (size.width / fftData.length) * 0.8 // spacing
+      ..strokeWidth = barWidth * 0.8 // spacing
       ..strokeCap = StrokeCap.square; // Technical look
 
-    final int bins = fftData.length;
-    final double barWidth = size.width / bins;
-
-    for (int i = 0; i < bins; i++) {
-      double magnitude = fftData[i];
-      // Log scale for better visualization
-      double db = magnitude > 0.000001 ? 20.0 * (math.log(magnitude) / math.ln10) : -100.0;
-      double normalized = ((db + 70) / 70).clamp(0.0, 1.0);
-      
+    for (int i = 0; i < count; i++) {
       // Enhance highs and lows artificially for visual punch
-      normalized = math.pow(normalized, 1.5).toDouble();
-
-      double barHeight = normalized * size.height;
+      final double normalized = math.pow(bands[i], 1.5).toDouble();
+      final double barHeight = normalized * size.height;
+      if (barHeight <= 0) continue;
 
       // Gradient effect
       paint.shader = LinearGradient(
@@ -341,13 +349,8 @@ class SpectrumPainter extends CustomPainter {
         end: Alignment.topCenter,
       ).createShader(Rect.fromLTWH(i * barWidth, size.height - barHeight, barWidth, barHeight));
 
-      if (barHeight > 0) {
-        canvas.drawLine(
-          Offset(i * barWidth, size.height),
-          Offset(i * barWidth, size.height - barHeight),
-          paint,
-        );
-      }
+      final double x = (i + 0.5) * barWidth;
+      canvas.drawLine(Offset(x, size.height), Offset(x, size.height - barHeight), paint);
     }
   }
 
@@ -0,0 +1,87 @@
+#include "chroma.h"
+#include <algorithm>
+#include <cmath>
+
+// Krumhansl-Kessler probe-tone profiles, tonic first
+static const float MAJOR_PROFILE[12] = { 6.35f, 2.23f, 3.48f, 2.33f, 4.38f, 4.09f, 2.52f, 5.19f, 2.39f, 3.66f, 2.29f, 2.88f };
+static const float MINOR_PROFILE[12] = { 6.33f, 2.68f, 3.52f, 5.38f, 2.60f, 3.53f, 2.54f, 4.75f, 3.98f, 2.69f, 3.34f, 3.17f };
+
+static float pearson(const float* a, const float* b, int32_t rotation) {
+    float meanA = 0.0f, meanB = 0.0f;
+    for (int i = 0; i < 12; ++i) { meanA += a[i]; meanB += b[i]; }
+    meanA /= 12.0f; meanB /= 12.0f;
+    float cov = 0.0f, varA = 0.0f, varB = 0.0f;
+    for (int i = 0; i < 12; ++i) {
+        float da = a[(i + rotation) % 12] - meanA, db = b[i] - meanB;
+        cov += da * db; varA += da * da; varB += db * db;
+    }
+    return (varA > 0.0f && varB > 0.0f) ? cov / std::sqrt(varA * varB) : 0.0f;
+}
+
+ChromaTracker::ChromaTracker(float sampleRate, int32_t fftSize, int32_t hopSize) :
+    hzPerBin(sampleRate / fftSize),
+    firstBin(std::max((int32_t)(MIN_HZ / hzPerBin), 1)),
+    lastBin(std::min((int32_t)(MAX_HZ / hzPerBin), fftSize / 2 - 2))
+{
+    const double hop = (double)hopSize / sampleRate;
+    fastAlpha = (float)(1.0 - std::exp(-hop / SMOOTHING_SECONDS));
+    slowAlpha = (float)(1.0 - std::exp(-hop / KEY_SECONDS));
+    reset();
+}
+
+void ChromaTracker::reset() {
+    std::fill_n(smoothed, PITCH_CLASSES, 0.0f);
+    std::fill_n(display, PITCH_CLASSES, 0.0f);
+    std::fill_n(profile, PITCH_CLASSES, 0.0f);
+    currentKey = -1;
+    keyCorrelation = 0.0f;
+}
+
+void ChromaTracker::process(const float* magnitudes) {
+    const float pi = 3.14159265f;
+    float raw[PITCH_CLASSES] = {};
+    float loudest = *std::max_element(magnitudes + firstBin, magnitudes + lastBin + 1);
+    for (int32_t k = firstBin; k <= lastBin; ++k) {
+        float m = magnitudes[k];
+        if (m <= loudest * PEAK_FLOOR || m <= magnitudes[k - 1] || m < magnitudes[k + 1]) continue;
+
+        // Parabola through the log magnitudes around the peak
+        float a = std::log(std::max(magnitudes[k - 1], 1e-12f)), b = std::log(m), c = std::log(std::max(magnitudes[k + 1], 1e-12f));
+        float offset = 0.5f * (a - c) / (a - 2.0f * b + c);
+        float energy = std::exp(2.0f * (b - 0.25f * (a - c) * offset));
+        float note = 69.0f + 12.0f * std::log2((k + offset) * hzPerBin / 440.0f);
+
+        int32_t nearest = (int32_t)std::floor(note + 0.5f);
+        for (int32_t n = nearest - 1; n <= nearest + 1; ++n) {
+            float d = (note - n) / WEIGHT_WIDTH;
+            if (std::fabs(d) < 0.5f) raw[((n % 12) + 12) % 12] += energy * std::cos(pi * d) * std::cos(pi * d);
+        }
+    }
+
+    float total = 0.0f;
+    for (float v : raw) total += v;
+    if (total > 1e-6f) {
+        // Loudness-independent: average shapes, not levels
+        for (int i = 0; i < PITCH_CLASSES; ++i) {
+            float v = raw[i] / total;
+            smoothed[i] += fastAlpha * (v - smoothed[i]);
+            profile[i] += slowAlpha * (v - profile[i]);
+        }
+        float peak = *std::max_element(smoothed, smoothed + PITCH_CLASSES);
+        for (int i = 0; i < PITCH_CLASSES; ++i) display[i] = smoothed[i] / peak;
+        estimateKey();
+    }
+}
+
+void ChromaTracker::estimateKey() {
+    float best = -2.0f;
+    int32_t bestKey = -1;
+    for (int32_t tonic = 0; tonic < 12; ++tonic) {
+        float major = pearson(profile, MAJOR_PROFILE, tonic);
+        float minor = pearson(profile, MINOR_PROFILE, tonic);
+        if (major > best) { best = major; bestKey = tonic; }
+        if (minor > best) { best = minor; bestKey = 12 + tonic; }
+    }
+    currentKey = bestKey;
+    keyCorrelation = best;
+}
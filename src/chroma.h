@@ -0,0 +1,49 @@
+#ifndef BAREMETAL_DSP_CHROMA_H
+#define BAREMETAL_DSP_CHROMA_H
+
+#include <cstdint>
+
+// Per-hop 12-bin chroma from FFT magnitudes, plus a running key estimate.
+// Harmonic pitch class profile: only spectral peaks count, each at its
+// parabolically interpolated frequency, so the 11.7 Hz bins of the
+// CHROMA_FFT_SIZE (4096-point) frame still resolve semitones and window
+// leakage does not smear into neighbouring classes.
+// A short moving average smooths the display chroma; a long one feeds
+// Krumhansl-Kessler template correlation. Single-threaded: the audio
+// thread owns it.
+class ChromaTracker {
+public:
+    static constexpr int32_t PITCH_CLASSES = 12;
+    static constexpr float SMOOTHING_SECONDS = 0.3f; // Display chroma time constant
+    static constexpr float KEY_SECONDS = 8.0f;       // Key profile time constant
+    static constexpr float MIN_HZ = 100.0f;
+    static constexpr float MAX_HZ = 5000.0f;
+    static constexpr float PEAK_FLOOR = 1e-3f;   // Peaks below -60 dB of the loudest are ignored
+    static constexpr float WEIGHT_WIDTH = 4.0f / 3.0f; // cos^2 window, semitones
+
+    ChromaTracker(float sampleRate, int32_t fftSize, int32_t hopSize);
+
+    void reset();
+    void process(const float* magnitudes);
+
+    const float* chroma() const { return display; } // Max-normalized, 0..1
+    // 0..11 = C..B major, 12..23 = C..B minor, -1 before any tonal input
+    int32_t key() const { return currentKey; }
+    float confidence() const { return keyCorrelation; } // Pearson r of the best key
+
+private:
+    float hzPerBin;
+    int32_t firstBin;
+    int32_t lastBin;
+    float fastAlpha;
+    float slowAlpha;
+    float smoothed[PITCH_CLASSES];
+    float display[PITCH_CLASSES];
+    float profile[PITCH_CLASSES];
+    int32_t currentKey;
+    float keyCorrelation;
+
+    void estimateKey();
+};
+
+#endif // BAREMETAL_DSP_CHROMA_H
@@ -0,0 +1,60 @@
+#include "clock_sync.h"
+#include <algorithm>
+#include <cmath>
+
+VideoClockSync::VideoClockSync() :
+    lastHost(0), integrator(0.0), primed(false),
+    currentRatio(1.0), lastError(0.0), drift(0.0), resync(false) {}
+
+void VideoClockSync::reset() {
+    std::lock_guard<std::mutex> lock(feedMutex);
+    lastHost = 0;
+    integrator = 0.0;
+    primed = false;
+    currentRatio.store(1.0, std::memory_order_relaxed);
+    lastError.store(0.0, std::memory_order_relaxed);
+    drift.store(0.0, std::memory_order_relaxed);
+    resync.store(false, std::memory_order_relaxed);
+}
+
+void VideoClockSync::feed(double videoPts, double audioTime, int64_t hostNanos) {
+    std::lock_guard<std::mutex> lock(feedMutex);
+    double error = audioTime - videoPts; // > 0: audio is ahead and must slow down
+    lastError.store(error, std::memory_order_relaxed);
+
+    if (std::fabs(error) > RESYNC_THRESHOLD) {
+        // A jump (seek, stall) is not drift: don't let it wind up the loop
+        integrator = 0.0;
+        primed = false;
+        currentRatio.store(1.0, std::memory_order_relaxed);
+        resync.store(true, std::memory_order_relaxed);
+        return;
+    }
+    resync.store(false, std::memory_order_relaxed);
+
+    double dt = primed ? (double)(hostNanos - lastHost) * 1e-9 : 0.0;
+    lastHost = hostNanos;
+    primed = true;
+    if (dt <= 0.0 || dt > 1.0) return; // First sample or a long gap: just re-anchor
+
+    // Butterworth loop (zeta = 1/sqrt2, slightly underdamped):
+    // e'' + kp e' + ki e = 0 with kp = 2 zeta omega, ki = omega^2
+    const double omega = 2.0 * 3.14159265358979323846 * LOOP_BANDWIDTH_HZ;
+    const double kp = std::sqrt(2.0) * omega;
+    const double ki = omega * omega;
+
+    integrator = std::clamp(integrator + ki * error * dt, -MAX_CORRECTION, MAX_CORRECTION);
+    double correction = std::clamp(kp * error + integrator, -MAX_CORRECTION, MAX_CORRECTION);
+
+    currentRatio.store(1.0 - correction, std::memory_order_relaxed);
+    drift.store(integrator * 1e6, std::memory_order_relaxed);
+}
+
+void VideoClockSync::stats(ClockSyncStats* out) const {
+    double error = lastError.load(std::memory_order_relaxed);
+    out->errorSeconds = error;
+    out->driftPpm = drift.load(std::memory_order_relaxed);
+    out->ratio = currentRatio.load(std::memory_order_relaxed);
+    out->locked = std::fabs(error) <= LOCK_TOLERANCE ? 1 : 0;
+    out->resyncNeeded = resync.load(std::memory_order_relaxed) ? 1 : 0;
+}
@@ -0,0 +1,51 @@
+#ifndef BAREMETAL_DSP_CLOCK_SYNC_H
+#define BAREMETAL_DSP_CLOCK_SYNC_H
+
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+// FFI view of the A/V lock (layout mirrored in lib/ffi_bridge.dart)
+struct ClockSyncStats {
+    double errorSeconds; // Audio clock minus video clock at the last timestamp
+    double driftPpm;     // Estimated audio-device vs video-clock rate offset
+    double ratio;        // Resampling ratio currently requested (input/output)
+    int32_t locked;      // Error within LOCK_TOLERANCE
+    int32_t resyncNeeded;// Error too large to slew away; the player should seek
+};
+
+// Delay-locked loop slaving the audio clock to external video timestamps.
+// A second-order PI loop turns the A/V error into a small resampling ratio
+// correction; the integrator converges to the clock drift, so the steady
+// state error is zero. Loop bandwidth is far below the video frame rate so
+// presentation jitter is filtered out rather than chased.
+class VideoClockSync {
+public:
+    static constexpr double LOOP_BANDWIDTH_HZ = 0.05;
+    static constexpr double MAX_CORRECTION = 0.005;  // +-5000 ppm, inaudible pitch shift
+    static constexpr double LOCK_TOLERANCE = 0.005;  // Seconds
+    static constexpr double RESYNC_THRESHOLD = 0.5;  // Seconds
+
+    VideoClockSync();
+
+    void reset();
+    // Called from the thread presenting video. `audioTime` is the engine's
+    // media clock sampled at `hostNanos`.
+    void feed(double videoPts, double audioTime, int64_t hostNanos);
+
+    double ratio() const { return currentRatio.load(std::memory_order_relaxed); } // Any thread
+    void stats(ClockSyncStats* out) const;
+
+private:
+    std::mutex feedMutex;
+    int64_t lastHost;
+    double integrator;
+    bool primed;
+
+    std::atomic<double> currentRatio;
+    std::atomic<double> lastError;
+    std::atomic<double> drift;
+    std::atomic<bool> resync;
+};
+
+#endif // BAREMETAL_DSP_CLOCK_SYNC_H
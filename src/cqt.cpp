@@ -0,0 +1,62 @@
+#include "cqt.h"
+#include <algorithm>
+#include <cmath>
+
+ConstantQ::ConstantQ(int32_t binsPerOctave, float minHz, float maxHz, float sampleRate, int32_t fftSize) :
+    plan(fftSize), offsets(1, 0), spectrum(fftSize)
+{
+    const double pi = 3.14159265358979323846;
+    const double q = 1.0 / (std::pow(2.0, 1.0 / binsPerOctave) - 1.0);
+    const int32_t count = (int32_t)std::floor(binsPerOctave * std::log2((double)maxHz / minHz)) + 1;
+    const int32_t half = fftSize / 2;
+    std::vector<std::complex<float>> kernel(fftSize);
+
+    for (int32_t k = 0; k < count; ++k) {
+        double hz = minHz * std::pow(2.0, (double)k / binsPerOctave);
+        int32_t length = std::min((int32_t)std::ceil(q * sampleRate / hz), fftSize);
+
+        // Temporal kernel: Hann-windowed exponential in the last `length`
+        // samples, scaled so a unit sine on the bin reads 1.0
+        std::fill(kernel.begin(), kernel.end(), std::complex<float>(0.0f, 0.0f));
+        double windowSum = 0.0;
+        for (int32_t n = 0; n < length; ++n) windowSum += 0.5 * (1.0 - std::cos(2.0 * pi * (n + 0.5) / length));
+        for (int32_t n = 0; n < length; ++n) {
+            double w = 0.5 * (1.0 - std::cos(2.0 * pi * (n + 0.5) / length)) / windowSum;
+            double phase = 2.0 * pi * hz * n / sampleRate;
+            kernel[fftSize - length + n] = std::complex<float>((float)(w * std::cos(phase)), (float)(w * std::sin(phase)));
+        }
+        plan.forward(kernel.data());
+
+        // Keep the significant run of positive-frequency coefficients. By
+        // Parseval, sum x[n] conj(k[n]) = sum X[j] conj(K[j]) / N; the 2 folds
+        // the negative-frequency half of a real sine back in.
+        float peak = 0.0f;
+        for (int32_t j = 0; j <= half; ++j) peak = std::max(peak, std::abs(kernel[j]));
+        int32_t first = 0, last = half;
+        while (first < last && std::abs(kernel[first]) < peak * KERNEL_THRESHOLD) ++first;
+        while (last > first && std::abs(kernel[last]) < peak * KERNEL_THRESHOLD) --last;
+
+        frequencies.push_back((float)hz);
+        firstBins.push_back(first);
+        for (int32_t j = first; j <= last; ++j) kernels.push_back(std::conj(kernel[j]) * (2.0f / fftSize));
+        offsets.push_back((uint32_t)kernels.size());
+    }
+}
+
+void ConstantQ::transform(const float* frame, float* out) {
+    const int32_t n = plan.size();
+    for (int32_t i = 0; i < n; ++i) spectrum[i] = std::complex<float>(frame[i], 0.0f);
+    plan.forward(spectrum.data());
+
+    for (int32_t b = 0; b < bins(); ++b) {
+        const std::complex<float>* w = kernels.data() + offsets[b];
+        const std::complex<float>* x = spectrum.data() + firstBins[b];
+        const uint32_t len = offsets[b + 1] - offsets[b];
+        float re = 0.0f, im = 0.0f;
+        for (uint32_t j = 0; j < len; ++j) {
+            re += x[j].real() * w[j].real() - x[j].imag() * w[j].imag();
+            im += x[j].real() * w[j].imag() + x[j].imag() * w[j].real();
+        }
+        out[b] = std::sqrt(re * re + im * im);
+    }
+}
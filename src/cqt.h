@@ -0,0 +1,39 @@
+#ifndef BAREMETAL_DSP_CQT_H
+#define BAREMETAL_DSP_CQT_H
+
+#include "fft.h"
+#include <complex>
+#include <vector>
+#include <cstdint>
+
+// Constant-Q transform by precomputed sparse spectral kernels (Brown &
+// Puckette, 1992). Each bin's windowed complex exponential is transformed
+// once; only its significant spectral coefficients are kept, so a transform
+// is one FFT of the frame plus a short complex dot product per bin.
+// Kernels are aligned to the end of the frame: every bin sees the newest
+// samples, bass bins simply look further back.
+class ConstantQ {
+public:
+    static constexpr float KERNEL_THRESHOLD = 0.0054f; // Relative to each kernel's peak
+
+    // binsPerOctave bins from minHz up to (at most) maxHz. Bins whose window
+    // would exceed fftSize are shortened, widening the lowest bins.
+    ConstantQ(int32_t binsPerOctave, float minHz, float maxHz, float sampleRate, int32_t fftSize);
+
+    int32_t bins() const { return (int32_t)firstBins.size(); }
+    int32_t fftSize() const { return plan.size(); }
+    float frequency(int32_t bin) const { return frequencies[bin]; }
+    // frame: fftSize() samples, oldest first. out: bins() magnitudes, where
+    // a full-scale sine on a bin center reads 1.0. Not thread-safe (scratch).
+    void transform(const float* frame, float* out);
+
+private:
+    FftPlan plan;
+    std::vector<float> frequencies;
+    std::vector<int32_t> firstBins;
+    std::vector<uint32_t> offsets; // Into `kernels`, bins() + 1 entries
+    std::vector<std::complex<float>> kernels;
+    std::vector<std::complex<float>> spectrum; // Scratch
+};
+
+#endif // BAREMETAL_DSP_CQT_H
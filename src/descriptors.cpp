@@ -0,0 +1,62 @@
+#include "descriptors.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+
+DescriptorExtractor::DescriptorExtractor(int32_t bins, float binHz)
+    : bins(bins), binHz(binHz), previous(bins, 0.0f), groupPower(bins / 4, 0.0f) {}
+
+void DescriptorExtractor::reset() {
+    std::fill(previous.begin(), previous.end(), 0.0f);
+}
+
+void DescriptorExtractor::process(const float* magnitudes, SpectralDescriptors* out) {
+    using namespace simd;
+    const f32x4 zero = set1(0.0f), tiny = set1(1e-20f), step = set1(4.0f * binHz);
+    f32x4 freq = setr(0.0f, binHz, 2.0f * binHz, 3.0f * binHz);
+    f32x4 sumMag = zero, sumFreqMag = zero, sumPower = zero, sumLog2 = zero, peak = zero, flux = zero;
+    float* prev = previous.data();
+
+    for (int32_t i = 0, g = 0; i < bins; i += 4, ++g) {
+        f32x4 m = load(magnitudes + i);
+        f32x4 p = mul(m, m);
+        sumMag = add(sumMag, m);
+        sumFreqMag = madd(freq, m, sumFreqMag);
+        sumPower = add(sumPower, p);
+        sumLog2 = add(sumLog2, log2Approx(max(p, tiny)));
+        peak = max(peak, p);
+        f32x4 rise = max(sub(m, load(prev + i)), zero);
+        flux = madd(rise, rise, flux);
+        store(prev + i, m);
+        groupPower[g] = hsum(p);
+        freq = add(freq, step);
+    }
+
+    out->flux = std::sqrt(hsum(flux));
+    const float total = hsum(sumPower);
+    if (total <= 1e-20f * bins) {
+        out->centroid = out->rolloff = out->flatness = out->crest = 0.0f;
+        return;
+    }
+
+    float lanes[4];
+    store(lanes, peak);
+    const float peakPower = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    const float meanPower = total / bins;
+    out->centroid = hsum(sumFreqMag) / hsum(sumMag);
+    out->flatness = std::min(std::exp2(hsum(sumLog2) / bins) / meanPower, 1.0f);
+    out->crest = peakPower / meanPower;
+
+    // Rolloff: walk the vector sums, then the four bins of the crossing vector
+    const float target = ROLLOFF_FRACTION * total;
+    float cumulative = 0.0f;
+    int32_t g = 0;
+    const int32_t groups = (int32_t)groupPower.size();
+    while (g < groups - 1 && cumulative + groupPower[g] < target) cumulative += groupPower[g++];
+    int32_t bin = g * 4;
+    for (int32_t end = bin + 3; bin < end; ++bin) {
+        cumulative += magnitudes[bin] * magnitudes[bin];
+        if (cumulative >= target) break;
+    }
+    out->rolloff = bin * binHz;
+}
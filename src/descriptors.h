@@ -0,0 +1,38 @@
+#ifndef BAREMETAL_DSP_DESCRIPTORS_H
+#define BAREMETAL_DSP_DESCRIPTORS_H
+
+#include <vector>
+#include <cstdint>
+
+// FFI view of one hop's spectral descriptors (layout mirrored in
+// lib/ffi_bridge.dart). All zero for a silent frame.
+struct SpectralDescriptors {
+    float centroid; // Hz, magnitude-weighted mean frequency
+    float rolloff;  // Hz below which ROLLOFF_FRACTION of the power lies
+    float flatness; // Geometric / arithmetic mean power, 0 (tonal) .. 1 (white)
+    float flux;     // L2 norm of the magnitude increase since the previous hop
+    float crest;    // Peak / mean power, 1 (flat) .. bins (one line)
+};
+
+// Computes every descriptor in one vectorized pass over the magnitudes: the
+// running sums, the log-power sum, the peak and the rectified difference to
+// the previous hop share each load. Rolloff needs a cumulative sum, so the
+// pass also records per-vector power and the split point is found on those.
+// `bins` must be a multiple of 4. Single-threaded: the audio thread owns it.
+class DescriptorExtractor {
+public:
+    static constexpr float ROLLOFF_FRACTION = 0.85f;
+
+    DescriptorExtractor(int32_t bins, float binHz);
+
+    void reset(); // Forget the previous hop (the next flux is measured from silence)
+    void process(const float* magnitudes, SpectralDescriptors* out);
+
+private:
+    int32_t bins;
+    float binHz;
+    std::vector<float> previous;   // Last hop's magnitudes
+    std::vector<float> groupPower; // Power per 4-bin vector of the current hop
+};
+
+#endif // BAREMETAL_DSP_DESCRIPTORS_H
@@ -1,23 +1,54 @@
 #define MINIAUDIO_IMPLEMENTATION
 #include "miniaudio.h"
 #include "engine.h"
+#include "engine_registry.h"
+#include "simd.h"
 #include <cmath>
 #include <complex>
 #include <algorithm>
-#include <sstream>
 #include <cstring> // For memset
+#include <chrono>
+#include <limits>
 
-const float PI = 3.14159265358979323846f;
-static DSPEngine* global_engine = nullptr;
+// Scheduler sleep bounds: the floor absorbs clock granularity at a boundary,
+// the ceiling bounds how stale a missed wake-up can get
+const double SUBTITLE_MIN_WAIT = 0.001;
+const double SUBTITLE_MAX_WAIT = 0.100;
+// Gain changes ramp over this many frames (~5 ms) to avoid zipper noise
+const uint32_t GAIN_RAMP_FRAMES = 256;
+// processSignal works through the period in sub-blocks of this size
+const uint32_t PROCESS_BLOCK = 256;
+// Resampler ratios are applied in whole ppm (what miniaudio resolves anyway)
+const uint32_t RATIO_DENOMINATOR = 1000000;
+// Handle behind the single-engine exports, -1 while none is alive
+static std::atomic<int32_t> default_engine{-1};
+static std::mutex default_engine_mutex;
 
-double parseTimestamp(const std::string& timestamp) {
-    int h, m, s, ms;
-    char sep;
-    std::stringstream ss(timestamp);
-    ss >> h >> sep >> m >> sep >> s >> sep >> ms;
-    return (h * 3600.0) + (m * 60.0) + s + (ms / 1000.0);
+// Process-wide backend context. Initializing one loads the backend and
+// enumerates devices, so it happens once and every engine shares it. It is
+// never uninitialized: engines may still be alive during static destruction.
+static std::mutex context_mutex; // Device init/uninit on the shared context
+static ma_context* shared_context() {
+    static ma_context* context = [] {
+        ma_context* c = new ma_context();
+        if (ma_context_init(NULL, 0, NULL, c) != MA_SUCCESS) { delete c; return (ma_context*)nullptr; }
+        return c;
+    }();
+    return context; // Null falls back to a per-device context
 }
 
+// Variable-rate stage between the decoder and the device, used while the
+// clock is slaved to video. Leftover input frames carry over between calls.
+struct PlaybackResampler {
+    static constexpr ma_uint64 INPUT_CAPACITY = 2048;
+    static constexpr uint32_t OUTPUT_BLOCK = 1024;
+
+    ma_linear_resampler resampler;
+    float input[INPUT_CAPACITY];
+    ma_uint64 inputFill;
+    uint32_t appliedRatio;
+};
+
 // Global Callback Wrapper
 void data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uint32 frameCount) {
     if (pDevice->pUserData != nullptr) {
@@ -27,36 +58,226 @@ void data_callback(ma_device* pDevice, void* pOutput, const void* pInput, ma_uin
 }
 
 DSPEngine::DSPEngine() : 
-    isRunning(false), currentMode(EngineMode::IDLE), device(nullptr), decoder(nullptr),
-    totalFramesProcessed(0), masterGain(1.0f), currentRms(0.0f), currentSubtitleIdx(-1),
-    prevInput(0.0f), prevOutput(0.0f), bufferIndex(0) 
+    isRunning(false), isPaused(false), currentMode(EngineMode::IDLE), deviceMode(EngineMode::IDLE),
+    device(nullptr), decoder(nullptr),
+    totalFramesProcessed(0), mediaClock(SAMPLE_RATE), latencyOverride(-1.0), reportedLatency(0.0),
+    videoSlaving((int32_t)VideoSlaving::AUTO), resampler(nullptr), resamplerEngaged(false), contentFrames(0),
+    currentRms(0.0f), clockJumped(false), gainTarget(1.0f), masterGain(1.0f),
+    rampGain(1.0f), rampStep(0.0f), rampFramesLeft(0),
+    schedulerExit(false), schedulerKicked(false),
+    starterExit(false), hasPendingStart(false), pendingMode(0), pendingHasPath(false),
+    pendingRequestTime(0), startTicket(0), lastReport(), stopGeneration(0),
+    prevInput(0.0f), prevOutput(0.0f), R(0.995f), bufferIndex(0),
+    fftPlan(FFT_SIZE), fftWindow(hannWindow(FFT_SIZE)),
+    descriptors(FFT_BINS, (float)SAMPLE_RATE / FFT_SIZE), fftFramePosition(0.0), fftFrameRate(1.0),
+    onsets(FFT_BINS, FFT_SIZE, SAMPLE_RATE), tempo(SAMPLE_RATE, FFT_SIZE),
+    melFilters(buildMelFilterbank(MEL_BANDS, MEL_MIN_HZ, MEL_MAX_HZ, SAMPLE_RATE, FFT_SIZE)),
+    mfccDct(MEL_BANDS, MFCC_COEFFS), peakMeter(SAMPLE_RATE),
+    pitch(fftPlan, SAMPLE_RATE), chromaTracker(SAMPLE_RATE, CHROMA_FFT_SIZE, FFT_SIZE),
+    chromaPlan(CHROMA_FFT_SIZE), chromaWindow(hannWindow(CHROMA_FFT_SIZE)),
+    chromaSamples(CHROMA_FFT_SIZE), chromaSpectrum(CHROMA_FFT_SIZE),
+    bandCount(0), bandMinHz(0.0f), bandMaxHz(0.0f), analysisHistory(nullptr), spectrogram(nullptr)
 {
     std::fill_n(sampleBuffer, FFT_SIZE, 0.0f);
     std::fill_n(fftMagnitudes, FFT_BINS, 0.0f);
+
+    subtitles.setPublishListener([this] { wakeSubtitleScheduler(); });
+    subtitleScheduler = std::thread(&DSPEngine::runSubtitleScheduler, this);
 }
 
 DSPEngine::~DSPEngine() {
+    {
+        std::lock_guard<std::mutex> lock(starterMutex);
+        starterExit = true;
+    }
+    starterWake.notify_one();
+    if (starter.joinable()) starter.join();
     stop();
+    releaseDevice();
+    applyCommands(UINT64_MAX); // Anything queued while stopped (source switches own decoders)
+    freeRetiredDecoders();
+    // A loader finishing now would wake the scheduler through the listener
+    // after its mutex is gone: join the loaders before the scheduler goes
+    subtitles.stopLoaders();
+    subtitles.setPublishListener(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        schedulerExit = true;
+    }
+    schedulerWake.notify_one();
+    subtitleScheduler.join();
 }
 
-void DSPEngine::start(int mode, const char* filePath) {
-    if (isRunning.load()) return;
+static double elapsed_ms(int64_t since) { return (double)(MediaClock::hostNanos() - since) * 1e-6; }
 
-    currentMode = (mode == 1) ? EngineMode::PLAYBACK : EngineMode::CAPTURE;
-    
-    ma_device_config config;
-    
-    if (currentMode == EngineMode::PLAYBACK) {
+StartError DSPEngine::start(int mode, const char* filePath) {
+    int64_t requested = MediaClock::hostNanos();
+    StartReport report = {};
+    StartError error = startStream(mode, filePath, report, stopGeneration.load());
+    report.totalMs = elapsed_ms(requested);
+    {
+        std::lock_guard<std::mutex> lock(starterMutex);
+        report.ticket = ++startTicket;
+        lastReport = report;
+    }
+    return error;
+}
+
+StartError DSPEngine::startStream(int mode, const char* filePath, StartReport& report, uint32_t generation) {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    auto fail = [&report](StartError error, int32_t result) {
+        report.state = (int32_t)StartState::FAILED;
+        report.error = (int32_t)error;
+        report.backendResult = result;
+        return error;
+    };
+    // A stop issued after the request was taken: stop() takes lifecycleMutex
+    // after bumping, so a start that passes this check is stopped by it
+    if (stopGeneration.load() != generation) return fail(StartError::CANCELLED, 0);
+    if (isRunning.load()) {
+        report.state = (int32_t)StartState::RUNNING;
+        report.error = (int32_t)StartError::ALREADY_RUNNING;
+        return StartError::ALREADY_RUNNING;
+    }
+
+    EngineMode requested = (mode == 1) ? EngineMode::PLAYBACK : EngineMode::CAPTURE;
+
+    if (requested == EngineMode::PLAYBACK) {
         // --- Setup Playback (File) ---
-        if (!filePath) return;
+        if (!filePath) return fail(StartError::NO_FILE, 0);
 
+        int64_t phase = MediaClock::hostNanos();
         decoder = new ma_decoder();
         ma_decoder_config decConfig = ma_decoder_config_init(ma_format_f32, 1, SAMPLE_RATE);
         
-        if (ma_decoder_init_file(filePath, &decConfig, decoder) != MA_SUCCESS) {
-            delete decoder; decoder = nullptr; return;
+        ma_result result = ma_decoder_init_file(filePath, &decConfig, decoder);
+        report.decoderOpenMs = elapsed_ms(phase);
+        if (result != MA_SUCCESS) {
+            delete decoder; decoder = nullptr;
+            return fail(StartError::DECODER_FAILED, result);
         }
 
+        // No anti-alias filter: the ratio never strays more than 0.5% from 1
+        ma_linear_resampler_config rsConfig = ma_linear_resampler_config_init(ma_format_f32, 1, RATIO_DENOMINATOR, RATIO_DENOMINATOR);
+        rsConfig.lpfOrder = 0;
+        resampler = new PlaybackResampler();
+        result = ma_linear_resampler_init(&rsConfig, NULL, &resampler->resampler);
+        if (result != MA_SUCCESS) {
+            delete resampler; resampler = nullptr;
+            releasePlaybackSource();
+            return fail(StartError::RESAMPLER_FAILED, result);
+        }
+    }
+
+    // Warm restart: a stopped device of the right direction is reused as is
+    if (device && deviceMode != requested) releaseDevice();
+    if (!device) {
+        int64_t phase = MediaClock::hostNanos();
+        int32_t result = openDevice(requested);
+        report.deviceInitMs = elapsed_ms(phase);
+        if (result != MA_SUCCESS) {
+            releasePlaybackSource();
+            return fail(StartError::DEVICE_INIT_FAILED, result);
+        }
+    }
+    currentMode = requested;
+
+    totalFramesProcessed.store(0);
+    contentFrames = 0;
+    resamplerEngaged = false;
+    videoSync.reset();
+    mediaClock.reset();
+    chromaTracker.reset();
+    loudness.reset();
+    peakMeter.reset();
+    pitch.reset();
+    descriptors.reset();
+    onsets.reset();
+    tempo.reset();
+    {
+        std::lock_guard<std::mutex> lock(onsetMutex);
+        while (onsetEvents.front()) onsetEvents.pop(); // Stale times from the last stream
+    }
+    bufferIndex = 0;
+    if (requested == EngineMode::PLAYBACK) enableAnalysisHistory(); // Chroma frames
+
+    int64_t phase = MediaClock::hostNanos();
+    ma_result result = ma_device_start(device);
+    report.deviceStartMs = elapsed_ms(phase);
+    if (result != MA_SUCCESS) {
+        releasePlaybackSource();
+        releaseDevice(); // A device that will not start is not worth caching
+        currentMode = EngineMode::IDLE;
+        return fail(StartError::DEVICE_START_FAILED, result);
+    }
+    isPaused.store(false);
+    isRunning.store(true);
+    wakeSubtitleScheduler();
+    report.state = (int32_t)StartState::RUNNING;
+    return StartError::NONE;
+}
+
+// --- Async Start ---
+uint32_t DSPEngine::startAsync(int mode, const char* filePath) {
+    uint32_t ticket;
+    {
+        std::lock_guard<std::mutex> lock(starterMutex);
+        ticket = ++startTicket;
+        pendingMode = mode;
+        pendingHasPath = filePath != nullptr;
+        pendingPath = filePath ? filePath : "";
+        pendingRequestTime = MediaClock::hostNanos();
+        hasPendingStart = true;
+        lastReport = {};
+        lastReport.ticket = ticket;
+        lastReport.state = (int32_t)StartState::STARTING;
+        if (!starter.joinable()) starter = std::thread(&DSPEngine::starterLoop, this);
+    }
+    starterWake.notify_one();
+    return ticket;
+}
+
+void DSPEngine::starterLoop() {
+    std::unique_lock<std::mutex> lock(starterMutex);
+    for (;;) {
+        starterWake.wait(lock, [this] { return hasPendingStart || starterExit; });
+        if (starterExit) return;
+        int mode = pendingMode;
+        std::string path = std::move(pendingPath);
+        bool hasPath = pendingHasPath;
+        int64_t requested = pendingRequestTime;
+        uint32_t ticket = startTicket;
+        uint32_t generation = stopGeneration.load();
+        hasPendingStart = false;
+        lock.unlock();
+
+        StartReport report = {};
+        startStream(mode, hasPath ? path.c_str() : nullptr, report, generation);
+        report.ticket = ticket;
+        report.totalMs = elapsed_ms(requested);
+
+        lock.lock();
+        if (!hasPendingStart) lastReport = report; // A newer request owns the report now
+    }
+}
+
+void DSPEngine::cancelPendingStart() {
+    std::lock_guard<std::mutex> lock(starterMutex);
+    stopGeneration.fetch_add(1); // Also cancels a request the worker already took
+    if (!hasPendingStart) return;
+    hasPendingStart = false;
+    lastReport.state = (int32_t)StartState::FAILED;
+    lastReport.error = (int32_t)StartError::CANCELLED;
+}
+
+void DSPEngine::getStartReport(StartReport* out) {
+    std::lock_guard<std::mutex> lock(starterMutex);
+    *out = lastReport;
+}
+
+int32_t DSPEngine::openDevice(EngineMode mode) {
+    ma_device_config config;
+    if (mode == EngineMode::PLAYBACK) {
         config = ma_device_config_init(ma_device_type_playback);
         config.playback.format   = ma_format_f32;
         config.playback.channels = 1; 
@@ -73,187 +294,996 @@ void DSPEngine::start(int mode, const char* filePath) {
     config.periodSizeInFrames = 256; 
 
     device = new ma_device();
-    if (ma_device_init(NULL, &config, device) != MA_SUCCESS) {
-        if (decoder) { ma_decoder_uninit(decoder); delete decoder; decoder = nullptr; }
+    ma_result result;
+    {
+        std::lock_guard<std::mutex> lock(context_mutex);
+        result = ma_device_init(shared_context(), &config, device);
+    }
+    if (result != MA_SUCCESS) {
         delete device; device = nullptr;
-        return;
+        return result;
     }
+    deviceMode = mode;
 
-    totalFramesProcessed.store(0);
-    ma_device_start(device);
-    isRunning.store(true);
+    // Device buffering between our callback and the speaker. Capture needs no
+    // compensation: the clock already counts frames as they arrive.
+    reportedLatency = 0.0;
+    if (mode == EngineMode::PLAYBACK && device->playback.internalSampleRate > 0) {
+        reportedLatency = (double)device->playback.internalPeriodSizeInFrames *
+                          device->playback.internalPeriods / device->playback.internalSampleRate;
+    }
+    applyLatency();
+    return MA_SUCCESS;
+}
+
+void DSPEngine::releaseDevice() {
+    if (!device) return;
+    {
+        std::lock_guard<std::mutex> lock(context_mutex);
+        ma_device_uninit(device);
+    }
+    delete device; device = nullptr;
+}
+
+void DSPEngine::releasePlaybackSource() {
+    if (decoder) {
+        ma_decoder_uninit(decoder);
+        delete decoder; decoder = nullptr;
+    }
+    if (resampler) {
+        ma_linear_resampler_uninit(&resampler->resampler, NULL);
+        delete resampler; resampler = nullptr;
+    }
 }
 
 void DSPEngine::stop() {
+    cancelPendingStart();
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
     if (isRunning.load()) {
-        if (device) {
-            ma_device_uninit(device);
-            delete device; device = nullptr;
-        }
-        if (decoder) {
-            ma_decoder_uninit(decoder);
-            delete decoder; decoder = nullptr;
+        // Stop the stream but keep the device for the next start
+        if (device) ma_device_stop(device);
+        {
+            // The audio thread is quiet: settle queued commands here
+            std::lock_guard<std::mutex> commandLock(commandMutex);
+            applyCommands(UINT64_MAX);
+            freeRetiredDecoders();
         }
+        releasePlaybackSource();
         isRunning.store(false);
+        isPaused.store(false);
         totalFramesProcessed.store(0);
+        mediaClock.reset();
+        videoSync.reset();
+        videoSlaving.store((int32_t)VideoSlaving::AUTO);
         currentMode = EngineMode::IDLE;
+        wakeSubtitleScheduler();
     }
 }
 
+void DSPEngine::pause() {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    if (!isRunning.load() || isPaused.load()) return;
+    ma_device_stop(device); // Returns once the callback can no longer run
+    isPaused.store(true);
+    videoSync.reset(); // The video pauses too; don't read the gap as drift
+    wakeSubtitleScheduler();
+}
+
+bool DSPEngine::resume() {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    if (!isRunning.load()) return false;
+    if (!isPaused.load()) return true;
+    isPaused.store(false);
+    if (ma_device_start(device) != MA_SUCCESS) {
+        isPaused.store(true); // Still stopped: the clock and scheduler must keep treating it as paused
+        return false;
+    }
+    wakeSubtitleScheduler();
+    return true;
+}
+
 // --- The Unified Core Loop ---
 void DSPEngine::onAudioData(void* pOutput, const void* pInput, uint32_t frameCount) {
     float tempBuffer[4096]; // Temp buffer for processing
-    const float* signalSource = nullptr;
+    int64_t blockHost = MediaClock::hostNanos();
+    uint64_t blockStart = totalFramesProcessed.load(std::memory_order_relaxed);
+
+    // Everything due at or before the block's first frame lands before it
+    applyCommands(blockStart);
+    float target = gainTarget.load(std::memory_order_relaxed);
+    if (target != masterGain) rampGainTo(target);
 
+    double rate = 1.0;
     if (currentMode == EngineMode::PLAYBACK) {
-        // Mode 1: Read from File -> Write to Speaker -> Analyze
-        ma_uint64 framesRead;
-        ma_decoder_read_pcm_frames(decoder, tempBuffer, frameCount, &framesRead);
-        
-        // Fill remaining with silence if EOF
-        if (framesRead < frameCount) {
-             // Loop or Stop? For now, silence.
-             memset(tempBuffer + framesRead, 0, (frameCount - framesRead) * sizeof(float));
+        // Slaving switches on the audio thread so the resampler has one owner
+        bool slaved = videoSlaving.load(std::memory_order_relaxed) == (int32_t)VideoSlaving::ON;
+        if (slaved != resamplerEngaged) {
+            resamplerEngaged = slaved;
+            ma_linear_resampler_reset(&resampler->resampler);
+            resampler->inputFill = 0;
+        }
+        if (resamplerEngaged) {
+            uint32_t ratio = (uint32_t)std::lround(videoSync.ratio() * RATIO_DENOMINATOR);
+            if (ratio != resampler->appliedRatio) {
+                ma_linear_resampler_set_rate(&resampler->resampler, ratio, RATIO_DENOMINATOR);
+                resampler->appliedRatio = ratio;
+            }
+            rate = (double)ratio / RATIO_DENOMINATOR;
         }
+    }
 
+    // Stamp the clock first so the host time is as close to the device IRQ as possible
+    mediaClock.onCallback((double)contentFrames, frameCount, rate, blockHost);
+
+    // Mode 1: Read from File -> Write to Speaker -> Analyze
+    // Mode 0: Read from Mic -> Analyze (No Output)
+    const float* signalSource = (currentMode == EngineMode::PLAYBACK) ? tempBuffer : (const float*)pInput;
+    float sumSq = 0.0f;
+    uint32_t done = 0;
+    while (done < frameCount) {
+        // A command due inside the block splits it, so it lands on its exact frame
+        uint32_t n = frameCount - done;
+        if (const EngineCommand* next = commands.front()) {
+            n = (uint32_t)std::min<uint64_t>(n, next->frame - (blockStart + done));
+        }
+        const double position = (double)contentFrames;
+        if (currentMode == EngineMode::PLAYBACK) {
+            contentFrames += renderPlayback(tempBuffer + done, n);
+        } else {
+            contentFrames += n;
+        }
+        // Common Processing (RMS, FFT)
+        if (signalSource) sumSq += processSignal(signalSource + done, n, position, rate);
+        done += n;
+
+        if (done < frameCount && applyCommands(blockStart + done)) {
+            // Content position jumped: re-anchor so the rest of the block reads right
+            mediaClock.onCallback((double)contentFrames - done * rate, frameCount, rate, blockHost);
+        }
+    }
+
+    if (currentMode == EngineMode::PLAYBACK) {
         // Output to hardware (Speakers)
         memcpy(pOutput, tempBuffer, frameCount * sizeof(float));
-        signalSource = tempBuffer; // Analyze what we hear
-    } else {
-        // Mode 0: Read from Mic -> Analyze (No Output)
-        signalSource = (const float*)pInput;
     }
+    if (signalSource) currentRms.store(std::sqrt(sumSq / frameCount), std::memory_order_relaxed);
+    // Device frames processed (the media clock counts content frames instead)
+    totalFramesProcessed.fetch_add(frameCount, std::memory_order_relaxed);
+}
 
-    // Common Processing (RMS, FFT, Subtitles, Clock)
-    if (signalSource) {
-        processSignal(signalSource, frameCount);
+// Decodes `frameCount` frames, through the resampler while slaved. Returns
+// the decoded (content) frames consumed.
+uint64_t DSPEngine::renderPlayback(float* out, uint32_t frameCount) {
+    if (resamplerEngaged) return readResampled(out, frameCount);
+
+    ma_uint64 framesRead;
+    ma_decoder_read_pcm_frames(decoder, out, frameCount, &framesRead);
+
+    // Fill remaining with silence if EOF
+    if (framesRead < frameCount) {
+         // Loop or Stop? For now, silence.
+         memset(out + framesRead, 0, (frameCount - framesRead) * sizeof(float));
     }
+    return frameCount;
 }
 
-void DSPEngine::processSignal(const float* buffer, uint32_t frames) {
-    float gain = masterGain.load(std::memory_order_relaxed);
-    
-    // Update Master Clock
-    uint64_t total = totalFramesProcessed.fetch_add(frames, std::memory_order_relaxed);
-    syncSubtitles((double)total / SAMPLE_RATE);
+// Block pipeline: ramped gain, DC blocker, sum of squares, FFT feed. Each
+// stage runs over a whole sub-block four samples at a time.
+float DSPEngine::processSignal(const float* buffer, uint32_t frames, double position, double rate) {
+    using namespace simd;
+    float scratch[PROCESS_BLOCK + 1]; // [0] carries the previous gained sample
+    float filtered[PROCESS_BLOCK];
+    const f32x4 r1 = set1(R);
+    const f32x4 r2 = set1(R * R);
+    const f32x4 rPowers = setr(R, R * R, R * R * R, R * R * R * R);
+    f32x4 acc = set1(0.0f);
+    float tailSq = 0.0f;
 
-    float sumSq = 0.0f;
-    for(uint32_t i=0; i<frames; ++i) {
-        float s = buffer[i] * gain; // Apply Gain
-        
-        // FFT & IIR
-        float f = s - prevInput + R * prevOutput;
-        prevInput = s; prevOutput = f;
-        sumSq += f*f;
-        
-        sampleBuffer[bufferIndex++] = f;
-        if(bufferIndex >= FFT_SIZE) {
-            computeFFT();
-            bufferIndex = 0;
+    for (uint32_t start = 0; start < frames; start += PROCESS_BLOCK) {
+        uint32_t n = std::min(frames - start, PROCESS_BLOCK);
+        const float* in = buffer + start;
+        float* gained = scratch + 1;
+        scratch[0] = prevInput;
+
+        // 1. Gain: a change ramps linearly over GAIN_RAMP_FRAMES instead of stepping
+        uint32_t i = 0;
+        uint32_t ramp = std::min(n, rampFramesLeft);
+        if (ramp > 0) {
+            f32x4 g = setr(rampGain + rampStep, rampGain + 2 * rampStep, rampGain + 3 * rampStep, rampGain + 4 * rampStep);
+            const f32x4 g4 = set1(4 * rampStep);
+            for (; i + 4 <= ramp; i += 4) {
+                store(gained + i, mul(load(in + i), g));
+                g = add(g, g4);
+            }
+            for (; i < ramp; ++i) gained[i] = in[i] * (rampGain + (i + 1) * rampStep);
+            rampFramesLeft -= ramp;
+            rampGain = rampFramesLeft ? rampGain + ramp * rampStep : masterGain; // Land exactly
+        }
+        const f32x4 g = set1(rampGain);
+        for (; i + 4 <= n; i += 4) store(gained + i, mul(load(in + i), g));
+        for (; i < n; ++i) gained[i] = in[i] * rampGain;
+
+        // 2. DC blocker y[n] = x[n] - x[n-1] + R*y[n-1], block-parallel: the
+        //    difference is plain SIMD, the recursion inside a vector is a
+        //    two-step prefix scan (R, R^2), then R^(k+1) carries y from the
+        //    previous vector in
+        float y = prevOutput;
+        i = 0;
+        for (; i + 4 <= n; i += 4) {
+            f32x4 v = sub(load(gained + i), load(gained + i - 1));
+            v = madd(shiftUp1(v), r1, v);
+            v = madd(shiftUp2(v), r2, v);
+            v = madd(rPowers, set1(y), v);
+            store(filtered + i, v);
+            acc = madd(v, v, acc); // 3. Sum of squares
+            y = lane3(v);
+        }
+        for (; i < n; ++i) {
+            float f = gained[i] - gained[i - 1] + R * y;
+            filtered[i] = f;
+            tailSq += f * f;
+            y = f;
         }
+        prevInput = gained[n - 1];
+        prevOutput = y;
+
+        // 4. FFT feed
+        if (SampleRing* history = analysisHistory.load(std::memory_order_acquire)) history->write(filtered, n);
+        for (uint32_t j = 0; j < n;) {
+            if (bufferIndex == 0) {
+                fftFramePosition = position + (start + j) * rate;
+                fftFrameRate = rate;
+            }
+            uint32_t chunk = std::min(n - j, (uint32_t)(FFT_SIZE - bufferIndex));
+            memcpy(sampleBuffer + bufferIndex, filtered + j, chunk * sizeof(float));
+            bufferIndex += chunk;
+            j += chunk;
+            if (bufferIndex >= FFT_SIZE) {
+                computeFFT();
+                bufferIndex = 0;
+            }
+        }
+
+        // 5. Loudness, on the signal as heard (before the DC blocker)
+        if (loudness.process(gained, n)) publishLoudness();
+        peakMeter.process(gained, n);
+
+        // 6. Pitch of the microphone, on the DC-free signal
+        if (currentMode == EngineMode::CAPTURE && pitch.process(filtered, n)) {
+            float packed[sizeof(PitchEstimate) / sizeof(float)];
+            memcpy(packed, &pitch.estimate(), sizeof(packed));
+            pitchFrame.publish(packed);
+        }
+    }
+
+    publishPeaks();
+    return hsum(acc) + tailSq;
+}
+
+// Meter snapshots: the audio thread, or a caller holding lifecycleMutex
+// while no callback can run
+void DSPEngine::publishLoudness() {
+    LoudnessStats stats;
+    double fields[sizeof(LoudnessStats) / sizeof(double)];
+    loudness.stats(&stats);
+    memcpy(fields, &stats, sizeof(stats));
+    loudnessFrame.publish(fields);
+}
+
+void DSPEngine::publishPeaks() {
+    PeakStats peaks;
+    double fields[sizeof(PeakStats) / sizeof(double)];
+    peakMeter.stats(&peaks);
+    memcpy(fields, &peaks, sizeof(peaks));
+    peakFrame.publish(fields);
+}
+
+// --- Command Queue ---
+// Audio thread (or a stopping caller once the device is quiet). Returns true
+// when the content position jumped.
+bool DSPEngine::applyCommands(uint64_t frame) {
+    bool jumped = false;
+    while (const EngineCommand* c = commands.front()) {
+        if (c->frame > frame) break;
+        switch (c->type) {
+        case CommandType::SET_GAIN:
+            // Becomes the latest value too, so the per-callback check keeps it
+            gainTarget.store((float)c->value, std::memory_order_relaxed);
+            rampGainTo((float)c->value);
+            break;
+        case CommandType::SET_DC_BLOCKER:
+            R = (float)c->value;
+            break;
+        case CommandType::SEEK:
+            if (currentMode == EngineMode::PLAYBACK && decoder) {
+                // Decoders with a seek table (WAV, FLAC) seek without scanning
+                ma_uint64 target = (ma_uint64)std::max(0.0, c->value * SAMPLE_RATE);
+                if (ma_decoder_seek_to_pcm_frame(decoder, target) == MA_SUCCESS) {
+                    contentFrames = target;
+                    jumped = true;
+                }
+            }
+            break;
+        case CommandType::RESET_LOUDNESS:
+            loudness.reset();
+            break;
+        case CommandType::RESET_PEAKS:
+            peakMeter.reset();
+            break;
+        case CommandType::SWITCH_SOURCE: {
+            ma_decoder* incoming = c->decoder;
+            if (currentMode == EngineMode::PLAYBACK && decoder) {
+                std::swap(decoder, incoming);
+                contentFrames = 0;
+                jumped = true;
+                chromaTracker.reset(); // New material, new key and tempo
+                tempo.reset();
+            }
+            retiredDecoders.push(incoming); // Freed by the next producer
+            break;
+        }
+        }
+        commands.pop();
+    }
+    if (jumped) {
+        if (resamplerEngaged) {
+            ma_linear_resampler_reset(&resampler->resampler);
+            resampler->inputFill = 0;
+        }
+        // No lock here: a missed wake-up only delays subtitles by SUBTITLE_MAX_WAIT
+        clockJumped.store(true, std::memory_order_release);
+        schedulerWake.notify_one();
+    }
+    return jumped;
+}
+
+// Audio thread: ramps from the gain reached so far to `target`.
+void DSPEngine::rampGainTo(float target) {
+    masterGain = target;
+    rampStep = (masterGain - rampGain) / GAIN_RAMP_FRAMES;
+    rampFramesLeft = GAIN_RAMP_FRAMES;
+}
+
+bool DSPEngine::pushCommands(const EngineCommand* batch, uint32_t count) {
+    std::lock_guard<std::mutex> lock(commandMutex);
+    freeRetiredDecoders();
+    return commands.pushAll(batch, count);
+}
+
+// Producers only (commandMutex held), or a stopping caller.
+void DSPEngine::freeRetiredDecoders() {
+    ma_decoder* old;
+    while (retiredDecoders.pop(old)) {
+        ma_decoder_uninit(old);
+        delete old;
     }
-    currentRms.store(std::sqrt(sumSq/frames), std::memory_order_relaxed);
 }
 
-// ... (Rest of FFT and Subtitle logic remains exactly the same) ...
-void DSPEngine::loadSubtitles(const char* srtContent) {
-     // Removed safety check per your request
-    subtitles.clear();
-    std::stringstream ss(srtContent);
-    std::string line;
-    SubtitleEvent ev;
-    int step = 0;
+bool DSPEngine::submitCommands(const DspCommand* batch, int32_t count) {
+    if (!batch || count <= 0 || (uint32_t)count > COMMAND_CAPACITY) return false;
+    EngineCommand converted[COMMAND_CAPACITY];
+    for (int32_t i = 0; i < count; ++i) {
+        CommandType type = (CommandType)batch[i].type;
+        bool external = batch[i].type >= 0 && type <= CommandType::RESET_PEAKS && type != CommandType::SWITCH_SOURCE;
+        if (!external) return false; // SWITCH_SOURCE needs a decoder: switchSource()
+        converted[i] = { type, batch[i].frame, batch[i].value, nullptr };
+    }
+    return pushCommands(converted, (uint32_t)count);
+}
+
+bool DSPEngine::seek(double seconds, uint64_t frame) {
+    EngineCommand c = { CommandType::SEEK, frame, seconds, nullptr };
+    return pushCommands(&c, 1);
+}
+
+bool DSPEngine::switchSource(const char* filePath, uint64_t frame) {
+    if (!filePath || !isRunning.load() || currentMode != EngineMode::PLAYBACK) return false;
+    ma_decoder* next = new ma_decoder();
+    ma_decoder_config decConfig = ma_decoder_config_init(ma_format_f32, 1, SAMPLE_RATE);
+    if (ma_decoder_init_file(filePath, &decConfig, next) != MA_SUCCESS) {
+        delete next;
+        return false;
+    }
+    EngineCommand c = { CommandType::SWITCH_SOURCE, frame, 0.0, next };
+    if (pushCommands(&c, 1)) return true;
+    ma_decoder_uninit(next);
+    delete next;
+    return false;
+}
+
+uint64_t DSPEngine::getFramePosition() const { return totalFramesProcessed.load(std::memory_order_relaxed); }
 
-    while (std::getline(ss, line)) {
-        if (!line.empty() && line.back() == '\r') line.pop_back();
-        if (line.empty()) {
-            if (step == 2) { subtitles.push_back(ev); ev.text.clear(); }
-            step = 0; continue;
+// Pulls `frameCount` output frames through the resampler, topping up its
+// input from the decoder. Returns the decoded frames consumed.
+uint64_t DSPEngine::readResampled(float* out, uint32_t frameCount) {
+    PlaybackResampler& rs = *resampler;
+    uint64_t consumed = 0;
+    uint32_t done = 0;
+    while (done < frameCount) {
+        ma_uint64 outFrames = std::min(frameCount - done, PlaybackResampler::OUTPUT_BLOCK);
+        ma_uint64 needed = 0;
+        ma_linear_resampler_get_required_input_frame_count(&rs.resampler, outFrames, &needed);
+        needed = std::min(needed, PlaybackResampler::INPUT_CAPACITY);
+        if (rs.inputFill < needed) {
+            ma_uint64 framesRead = 0;
+            ma_decoder_read_pcm_frames(decoder, rs.input + rs.inputFill, needed - rs.inputFill, &framesRead);
+            if (rs.inputFill + framesRead < needed) { // EOF: pad with silence, as the direct path does
+                memset(rs.input + rs.inputFill + framesRead, 0, (needed - rs.inputFill - framesRead) * sizeof(float));
+            }
+            rs.inputFill = needed;
         }
-        if (step == 0) step = 1;
-        else if (step == 1) {
-            ev.startTime = parseTimestamp(line.substr(0, 12));
-            ev.endTime = parseTimestamp(line.substr(17, 12));
-            step = 2;
-        } else if (step == 2) {
-            if (!ev.text.empty()) ev.text += "\n";
-            ev.text += line;
+
+        ma_uint64 inFrames = rs.inputFill;
+        ma_linear_resampler_process_pcm_frames(&rs.resampler, rs.input, &inFrames, out + done, &outFrames);
+        rs.inputFill -= inFrames;
+        if (rs.inputFill > 0) memmove(rs.input, rs.input + inFrames, rs.inputFill * sizeof(float));
+        consumed += inFrames;
+        done += (uint32_t)outFrames;
+        if (outFrames == 0) { // Defensive: never spin, fill the rest with silence
+            memset(out + done, 0, (frameCount - done) * sizeof(float));
+            break;
         }
     }
-    if (step == 2 && !ev.text.empty()) subtitles.push_back(ev);
+    return consumed;
 }
 
-void DSPEngine::syncSubtitles(double timestamp) {
-    if (subtitles.empty()) return;
-    int32_t current = currentSubtitleIdx.load(std::memory_order_relaxed);
-    if (current >= 0 && current < (int32_t)subtitles.size()) {
-        if (timestamp >= subtitles[current].startTime && timestamp <= subtitles[current].endTime) return;
+// --- Subtitle Scheduler ---
+void DSPEngine::wakeSubtitleScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(schedulerMutex);
+        schedulerKicked = true;
     }
-    auto it = std::upper_bound(subtitles.begin(), subtitles.end(), timestamp, 
-        [](double val, const SubtitleEvent& e) { return val < e.startTime; });
+    schedulerWake.notify_one();
+}
+
+void DSPEngine::runSubtitleScheduler() {
+    auto woken = [this] { return schedulerExit || schedulerKicked || clockJumped.load(std::memory_order_acquire); };
+    std::unique_lock<std::mutex> lock(schedulerMutex);
+    while (!schedulerExit) {
+        schedulerKicked = false;
+        clockJumped.store(false, std::memory_order_relaxed);
+        lock.unlock();
+        double now = getCurrentTime();
+        subtitles.sync(now);
+        double wait = subtitles.nextBoundary() - now;
+        lock.lock();
 
-    int32_t found = -1;
-    if (it != subtitles.begin()) {
-        auto candidate = std::prev(it);
-        if (timestamp >= candidate->startTime && timestamp <= candidate->endTime) {
-            found = (int32_t)std::distance(subtitles.begin(), candidate);
+        if (woken()) continue;
+        if (!isRunning.load() || isPaused.load()) {
+            schedulerWake.wait(lock, woken); // Clock is frozen, nothing can change
+        } else {
+            wait = std::min(std::max(wait, SUBTITLE_MIN_WAIT), SUBTITLE_MAX_WAIT);
+            schedulerWake.wait_for(lock, std::chrono::duration<double>(wait), woken);
         }
     }
-    if (found != current) currentSubtitleIdx.store(found, std::memory_order_release);
+}
+
+int32_t DSPEngine::openSubtitleTrack() { return subtitles.open(); }
+void DSPEngine::closeSubtitleTrack(int32_t track) { subtitles.close(track); }
+
+void DSPEngine::loadSubtitles(int32_t track, const char* content) {
+    if (SubtitleTrack* t = subtitles.track(track)) t->publish(parseSubtitles(content, std::strlen(content)));
+}
+
+void DSPEngine::loadSubtitlesFile(int32_t track, const char* path) {
+    if (SubtitleTrack* t = subtitles.track(track)) t->loadFileAsync(path);
 }
 
 void DSPEngine::computeFFT() {
     std::complex<float> data[FFT_SIZE];
-    for(int i=0; i<FFT_SIZE; i++) {
-        float win = 0.5f * (1.0f - std::cos(2.0f * PI * i / (FFT_SIZE-1)));
-        data[i] = std::complex<float>(sampleBuffer[i] * win, 0.0f);
-    }
-    for (int i=1, j=0; i<FFT_SIZE; i++) {
-        int bit = FFT_SIZE >> 1;
-        for (; j & bit; bit >>= 1) j ^= bit;
-        j ^= bit;
-        if (i < j) std::swap(data[i], data[j]);
-    }
-    for (int len=2; len<=FFT_SIZE; len<<=1) {
-        float angle = -2.0f * PI / len;
-        std::complex<float> wlen(std::cos(angle), std::sin(angle));
-        for (int i=0; i<FFT_SIZE; i+=len) {
-            std::complex<float> w(1.0f, 0.0f);
-            for (int j=0; j<len/2; j++) {
-                std::complex<float> u = data[i+j], v = data[i+j+len/2]*w;
-                data[i+j] = u+v; data[i+j+len/2] = u-v; w *= wlen;
-            }
+    fftPlan.forward(sampleBuffer, fftWindow.data(), data);
+    for(int i=0; i<FFT_BINS; i++) fftMagnitudes[i] = std::abs(data[i]) / (FFT_SIZE/2.0f);
+    spectrum.publish(fftMagnitudes);
+
+    SpectralDescriptors d;
+    float packed[sizeof(SpectralDescriptors) / sizeof(float)];
+    descriptors.process(fftMagnitudes, &d);
+    memcpy(packed, &d, sizeof(d));
+    descriptorFrame.publish(packed);
+
+    OnsetEvent onset;
+    if (onsets.process(fftMagnitudes, sampleBuffer, fftFramePosition, fftFrameRate, &onset)) {
+        onsetEvents.push(onset); // Dropped if nobody drains
+    }
+    tempo.process(onsets.novelty(), onsets.noveltyPosition());
+    const double beat[4] = {
+        tempo.bpm(), tempo.confidence(), tempo.period() / SAMPLE_RATE,
+        tempo.lastBeat() >= 0.0 ? tempo.lastBeat() / SAMPLE_RATE : -1.0
+    };
+    tempoFrame.publish(beat);
+
+    // Mel features: sparse filterbank on the power spectrum, log, DCT-II
+    float power[FFT_BINS];
+    float features[MEL_BANDS + MFCC_COEFFS];
+    for (int i = 0; i < FFT_BINS; i++) power[i] = fftMagnitudes[i] * fftMagnitudes[i];
+    melFilters.apply(power, features);
+    powerToLog(features, features, MEL_BANDS, 1e-10f);
+    mfccDct.apply(features, features + MEL_BANDS);
+    melFeatures.publish(features);
+
+    SampleRing* history = analysisHistory.load(std::memory_order_acquire);
+    if (currentMode == EngineMode::PLAYBACK && history) computeChroma(*history);
+
+    if (SpectrogramHistory* history = spectrogram.load(std::memory_order_acquire)) history->push(fftMagnitudes);
+}
+
+int32_t DSPEngine::getSpectrumBands(float* out, int32_t count, float minHz, float maxHz, float floorDb, float ceilDb) {
+    const float nyquist = SAMPLE_RATE / 2.0f;
+    maxHz = std::min(maxHz, nyquist);
+    if (!out || count <= 0 || count > MAX_SPECTRUM_BANDS || minHz <= 0.0f || maxHz <= minHz || ceilDb <= floorDb) return 0;
+
+    float power[FFT_BINS];
+    spectrum.read(power);
+    for (int i = 0; i < FFT_BINS; i++) power[i] *= power[i];
+
+    float bands[MAX_SPECTRUM_BANDS];
+    {
+        std::lock_guard<std::mutex> lock(bandMutex);
+        if (count != bandCount || minHz != bandMinHz || maxHz != bandMaxHz) {
+            bandMap = buildLogBands(count, minHz, maxHz, SAMPLE_RATE, FFT_SIZE);
+            bandCount = count; bandMinHz = minHz; bandMaxHz = maxHz;
         }
+        bandMap.apply(power, bands);
     }
-    for(int i=0; i<FFT_BINS; i++) fftMagnitudes[i] = std::abs(data[i]) / (FFT_SIZE/2.0f);
+    powerToNormalizedDb(bands, out, count, floorDb, ceilDb);
+    return count;
+}
+
+uint64_t DSPEngine::getSpectralDescriptors(SpectralDescriptors* out) const {
+    float packed[sizeof(SpectralDescriptors) / sizeof(float)];
+    uint64_t hop = descriptorFrame.read(packed);
+    memcpy(out, packed, sizeof(*out));
+    return hop;
+}
+
+int32_t DSPEngine::drainOnsets(OnsetEvent* out, int32_t capacity) {
+    std::lock_guard<std::mutex> lock(onsetMutex);
+    int32_t count = 0;
+    while (count < capacity && onsetEvents.pop(out[count])) ++count;
+    return count;
+}
+
+void DSPEngine::getTempo(TempoStats* out) const {
+    double beat[4];
+    *out = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    if (tempoFrame.read(beat) == 0 || beat[2] <= 0.0 || beat[3] < 0.0) return;
+    out->bpm = beat[0];
+    out->confidence = beat[1];
+    out->period = beat[2];
+    out->lastBeat = beat[3];
+    double beats = (mediaClock.now() - beat[3]) / beat[2];
+    double whole = std::floor(beats);
+    out->phase = beats - whole;
+    out->nextBeat = beat[3] + (whole + 1.0) * beat[2];
+}
+
+uint64_t DSPEngine::getPitch(PitchEstimate* out) const {
+    float packed[sizeof(PitchEstimate) / sizeof(float)];
+    uint64_t hop = pitchFrame.read(packed);
+    memcpy(out, packed, sizeof(*out));
+    return hop;
+}
+
+uint64_t DSPEngine::getMelFeatures(float* mel, float* mfcc) const {
+    float features[MEL_BANDS + MFCC_COEFFS];
+    uint64_t hop = melFeatures.read(features);
+    if (mel) std::copy_n(features, MEL_BANDS, mel);
+    if (mfcc) std::copy_n(features + MEL_BANDS, MFCC_COEFFS, mfcc);
+    return hop;
+}
+
+void DSPEngine::computeChroma(SampleRing& history) {
+    history.readLatest(chromaSamples.data(), CHROMA_FFT_SIZE); // Own writes: never retries
+    chromaPlan.forward(chromaSamples.data(), chromaWindow.data(), chromaSpectrum.data());
+    // Magnitudes in place, same scaling as fftMagnitudes
+    float* magnitudes = chromaSamples.data();
+    for (int i = 0; i < CHROMA_FFT_SIZE / 2; i++) magnitudes[i] = std::abs(chromaSpectrum[i]) / (CHROMA_FFT_SIZE / 2.0f);
+    chromaTracker.process(magnitudes);
+
+    float chroma[ChromaTracker::PITCH_CLASSES + 2];
+    std::copy_n(chromaTracker.chroma(), ChromaTracker::PITCH_CLASSES, chroma);
+    chroma[ChromaTracker::PITCH_CLASSES] = (float)chromaTracker.key();
+    chroma[ChromaTracker::PITCH_CLASSES + 1] = chromaTracker.confidence();
+    chromaFrame.publish(chroma);
+}
+
+uint64_t DSPEngine::getChroma(float* out) const {
+    float frame[ChromaTracker::PITCH_CLASSES + 2];
+    uint64_t hop = chromaFrame.read(frame);
+    if (out) std::copy_n(frame, ChromaTracker::PITCH_CLASSES, out);
+    return hop;
+}
+
+int32_t DSPEngine::getKey(float* confidence) const {
+    float frame[ChromaTracker::PITCH_CLASSES + 2];
+    if (chromaFrame.read(frame) == 0) return -1;
+    if (confidence) *confidence = frame[ChromaTracker::PITCH_CLASSES + 1];
+    return (int32_t)frame[ChromaTracker::PITCH_CLASSES];
+}
+
+SampleRing* DSPEngine::enableAnalysisHistory() {
+    std::lock_guard<std::mutex> lock(analysisMutex);
+    if (!analysisStorage) {
+        analysisStorage.reset(new SampleRing(ANALYSIS_HISTORY));
+        analysisHistory.store(analysisStorage.get(), std::memory_order_release);
+    }
+    return analysisStorage.get();
+}
+
+int32_t DSPEngine::configureConstantQ(int32_t binsPerOctave, float minHz, float maxHz) {
+    maxHz = std::min(maxHz, SAMPLE_RATE / 2.0f);
+    if (binsPerOctave <= 0 || minHz <= 0.0f || maxHz <= minHz) return 0;
+    // Cheap estimate first, so absurd requests never design a kernel
+    if (std::floor(binsPerOctave * std::log2(maxHz / minHz)) + 1 > MAX_CQT_BINS) return 0;
+
+    // Kernel design takes a few FFTs per bin; keep it out of the lock
+    std::unique_ptr<ConstantQ> transform(new ConstantQ(binsPerOctave, minHz, maxHz, SAMPLE_RATE, CQT_FFT_SIZE));
+    int32_t bins = transform->bins();
+    // The float estimate can round below the double bin count the kernel
+    // actually built; getConstantQ's buffer holds MAX_CQT_BINS
+    if (bins <= 0 || bins > MAX_CQT_BINS) return 0;
+    enableAnalysisHistory();
+    std::lock_guard<std::mutex> lock(cqtMutex);
+    constantQ = std::move(transform);
+    cqtFrame.resize(CQT_FFT_SIZE);
+    return bins;
+}
+
+int32_t DSPEngine::getConstantQ(float* out, int32_t capacity, float floorDb, float ceilDb) {
+    std::lock_guard<std::mutex> lock(cqtMutex);
+    if (!constantQ || !out || capacity <= 0 || ceilDb <= floorDb) return 0;
+    if (constantQ->bins() > MAX_CQT_BINS) return 0; // transform() fills every bin
+
+    float bins[MAX_CQT_BINS];
+    int32_t count = std::min({ capacity, constantQ->bins(), (int32_t)MAX_CQT_BINS });
+    analysisHistory.load(std::memory_order_acquire)->readLatest(cqtFrame.data(), CQT_FFT_SIZE);
+    constantQ->transform(cqtFrame.data(), bins);
+    for (int32_t i = 0; i < count; i++) bins[i] *= bins[i];
+    powerToNormalizedDb(bins, out, count, floorDb, ceilDb);
+    return count;
+}
+
+bool DSPEngine::configureSpectrogram(int32_t columns, int32_t rows, float minHz, float maxHz) {
+    std::lock_guard<std::mutex> lock(spectrogramMutex);
+    if (!spectrogramRaster.configure(columns, rows, minHz, maxHz, SAMPLE_RATE, FFT_SIZE)) return false;
+    if (spectrogramStorage && spectrogramStorage->capacity() >= columns) return true;
+
+    // The history holds as many spectra as the widest image asked for. A
+    // wider one swaps in a new ring (recording restarts); the audio thread
+    // may still be pushing into the old one, so it is freed only once no
+    // callback can run, at the latest with the engine.
+    if (spectrogramStorage) retiredSpectrograms.push_back(std::move(spectrogramStorage));
+    spectrogramStorage.reset(new SpectrogramHistory(FFT_BINS, columns));
+    spectrogram.store(spectrogramStorage.get(), std::memory_order_release);
+    std::lock_guard<std::mutex> lifecycle(lifecycleMutex);
+    if (!isRunning.load() || isPaused.load()) retiredSpectrograms.clear();
+    return true;
+}
+
+void DSPEngine::setSpectrogramColormap(int32_t colormap, float floorDb, float ceilDb) {
+    std::lock_guard<std::mutex> lock(spectrogramMutex);
+    spectrogramRaster.setColormap((SpectrogramColormap)colormap, floorDb, ceilDb);
+}
+
+void DSPEngine::setSpectrogramLut(const uint8_t* rgba, float floorDb, float ceilDb) {
+    std::lock_guard<std::mutex> lock(spectrogramMutex);
+    if (rgba) spectrogramRaster.setColormap(rgba, floorDb, ceilDb);
+}
+
+bool DSPEngine::getSpectrogram(SpectrogramView* out) {
+    std::lock_guard<std::mutex> lock(spectrogramMutex);
+    if (!out || !spectrogramRaster.configured()) return false;
+    spectrogramRaster.update(*spectrogramStorage, out);
+    return true;
 }
 
 // --- Getter Setters ---
 float DSPEngine::getRms() { return currentRms.load(std::memory_order_relaxed); }
 float* DSPEngine::getFftData() { return fftMagnitudes; }
-double DSPEngine::getCurrentTime() const { 
-    return (double)totalFramesProcessed.load(std::memory_order_relaxed) / (double)SAMPLE_RATE; 
+double DSPEngine::getCurrentTime() const { return mediaClock.now(); }
+void DSPEngine::applyLatency() {
+    double measured = latencyOverride.load(std::memory_order_relaxed);
+    mediaClock.setLatency(measured >= 0.0 ? measured : reportedLatency);
+}
+void DSPEngine::setOutputLatency(double seconds) {
+    latencyOverride.store(seconds, std::memory_order_relaxed);
+    applyLatency();
+}
+double DSPEngine::getOutputLatency() const { return mediaClock.latency(); }
+void DSPEngine::feedVideoClock(double pts) {
+    if (!isRunning.load() || isPaused.load() || currentMode != EngineMode::PLAYBACK) return;
+    videoSync.feed(pts, mediaClock.now(), MediaClock::hostNanos());
+    // Only AUTO turns on: a caller's explicit OFF is never overridden
+    int32_t automatic = (int32_t)VideoSlaving::AUTO;
+    videoSlaving.compare_exchange_strong(automatic, (int32_t)VideoSlaving::ON, std::memory_order_relaxed);
+}
+void DSPEngine::setVideoClockSlaving(bool enabled) {
+    if (!enabled) videoSync.reset(); // Back to ratio 1 before the audio thread bypasses
+    videoSlaving.store((int32_t)(enabled ? VideoSlaving::ON : VideoSlaving::OFF), std::memory_order_relaxed);
+}
+void DSPEngine::getClockSyncStats(ClockSyncStats* out) const { videoSync.stats(out); }
+
+void DSPEngine::getLoudness(LoudnessStats* out) const {
+    const double silent = -std::numeric_limits<double>::infinity();
+    double fields[sizeof(LoudnessStats) / sizeof(double)];
+    if (loudnessFrame.read(fields) == 0) {
+        *out = { silent, silent, silent, 0.0, silent, silent, 0.0 };
+        return;
+    }
+    memcpy(out, fields, sizeof(fields));
+}
+
+void DSPEngine::getPeaks(PeakStats* out) const {
+    const double silent = -std::numeric_limits<double>::infinity();
+    double fields[sizeof(PeakStats) / sizeof(double)];
+    if (peakFrame.read(fields) == 0) {
+        *out = { silent, silent, silent, silent, silent, silent };
+        return;
+    }
+    memcpy(out, fields, sizeof(fields));
+}
+
+// The queue only drains inside the callback, so with no stream running the
+// meters are reset here and republished; otherwise a full queue is reported.
+bool DSPEngine::resetPeaks() {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    if (!isRunning.load() || isPaused.load()) {
+        peakMeter.reset();
+        publishPeaks();
+        return true;
+    }
+    EngineCommand c = { CommandType::RESET_PEAKS, 0, 0.0, nullptr };
+    return pushCommands(&c, 1);
+}
+
+bool DSPEngine::resetLoudness() {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    if (!isRunning.load() || isPaused.load()) {
+        loudness.reset();
+        publishLoudness();
+        return true;
+    }
+    EngineCommand c = { CommandType::RESET_LOUDNESS, 0, 0.0, nullptr };
+    return pushCommands(&c, 1);
+}
+void DSPEngine::setMasterGain(float gain) {
+    gainTarget.store(gain, std::memory_order_relaxed); // Ramped to at the next callback
+}
+int32_t DSPEngine::getSubtitleLoadStatus(int32_t track) const {
+    const SubtitleTrack* t = subtitles.track(track);
+    return t ? (int32_t)t->loadState() : (int32_t)SubtitleLoadState::IDLE;
+}
+int32_t DSPEngine::getActiveSubtitleIndex(int32_t track) const {
+    const SubtitleTrack* t = subtitles.track(track);
+    return t ? t->active().first() : -1;
+}
+int32_t DSPEngine::getActiveSubtitles(int32_t track, int32_t* out, int32_t capacity) const {
+    const SubtitleTrack* t = subtitles.track(track);
+    return t ? t->active().read(out, capacity) : 0;
+}
+int32_t DSPEngine::getAllActiveSubtitles(SubtitleActiveEntry* out, int32_t capacity) const {
+    return subtitles.readActive(out, capacity);
 }
-void DSPEngine::setMasterGain(float gain) { masterGain.store(gain, std::memory_order_relaxed); }
-int32_t DSPEngine::getActiveSubtitleIndex() const { return currentSubtitleIdx.load(std::memory_order_relaxed); }
-const char* DSPEngine::getSubtitleText(int32_t index) const {
-    if (index >= 0 && index < (int32_t)subtitles.size()) return subtitles[index].text.c_str();
+uint32_t DSPEngine::getSubtitleGeneration() const { return subtitles.generation(); }
+const char* DSPEngine::getSubtitleText(int32_t track, int32_t index) const {
+    const SubtitleTrack* t = subtitles.track(track);
+    const CueSource* table = t ? t->source() : nullptr;
+    if (table && index >= 0 && index < table->size()) return table->text(index);
+    return "";
+}
+bool DSPEngine::getSubtitleCue(int32_t track, int32_t index, SubtitleCueInfo* out) const {
+    const SubtitleTrack* t = subtitles.track(track);
+    const CueSource* table = t ? t->source() : nullptr;
+    if (!table || !out || index < 0 || index >= table->size()) return false;
+    table->describe(index, out);
+    return true;
+}
+int32_t DSPEngine::getSubtitleLookahead(int32_t track, SubtitleCueInfo* out, int32_t count) const {
+    const SubtitleTrack* t = subtitles.track(track);
+    const CueSource* table = t ? t->source() : nullptr;
+    if (!table || !out || count <= 0) return 0;
+    return table->upcoming(getCurrentTime(), out, count);
+}
+int32_t DSPEngine::appendSubtitles(int32_t track, const char* content) {
+    SubtitleTrack* t = subtitles.track(track);
+    return t ? t->append(content, std::strlen(content)) : 0;
+}
+bool DSPEngine::amendLastSubtitle(int32_t track, double endTime, const char* text) {
+    SubtitleTrack* t = subtitles.track(track);
+    return t && t->amendLast(endTime, text, text ? std::strlen(text) : 0);
+}
+const char* DSPEngine::getSubtitleStyleName(int32_t track, int32_t styleId) const {
+    const SubtitleTrack* t = subtitles.track(track);
+    const CueSource* table = t ? t->source() : nullptr;
+    if (table && styleId >= 0 && styleId < table->styleCount()) return table->styleName(styleId);
     return "";
 }
 
 // --- EXPORTS ---
+EXPORT int32_t dsp_create() { return EngineRegistry::instance().create(); }
+EXPORT int32_t dsp_retain(int32_t h) { return EngineRegistry::instance().retain(h) ? 1 : 0; }
+EXPORT void dsp_destroy(int32_t h) { EngineRegistry::instance().destroy(h); }
+EXPORT int32_t dsp_start(int32_t h, int mode, const char* path) {
+    EngineRef e(h);
+    return (int32_t)(e ? e->start(mode, path) : StartError::INVALID_HANDLE);
+}
+EXPORT uint32_t dsp_start_async(int32_t h, int mode, const char* path) { EngineRef e(h); return e ? e->startAsync(mode, path) : 0; }
+EXPORT int32_t dsp_get_start_report(int32_t h, StartReport* out) {
+    EngineRef e(h);
+    if (!e || !out) return 0;
+    e->getStartReport(out);
+    return 1;
+}
+EXPORT void dsp_stop(int32_t h) { EngineRef e(h); if (e) e->stop(); }
+EXPORT void dsp_pause(int32_t h) { EngineRef e(h); if (e) e->pause(); }
+EXPORT int32_t dsp_resume(int32_t h) { EngineRef e(h); return (e && e->resume()) ? 1 : 0; }
+EXPORT int32_t dsp_is_paused(int32_t h) { EngineRef e(h); return (e && e->paused()) ? 1 : 0; }
+EXPORT float dsp_get_rms_level(int32_t h) { EngineRef e(h); return e ? e->getRms() : 0.0f; }
+EXPORT float* dsp_get_fft_array(int32_t h) { EngineRef e(h); return e ? e->getFftData() : nullptr; }
+EXPORT int32_t dsp_get_spectrum_bands(int32_t h, float* out, int32_t count, float minHz, float maxHz, float floorDb, float ceilDb) {
+    EngineRef e(h);
+    return e ? e->getSpectrumBands(out, count, minHz, maxHz, floorDb, ceilDb) : 0;
+}
+EXPORT uint64_t dsp_get_mel_features(int32_t h, float* mel, float* mfcc) { EngineRef e(h); return e ? e->getMelFeatures(mel, mfcc) : 0; }
+EXPORT uint64_t dsp_get_spectral_descriptors(int32_t h, SpectralDescriptors* out) {
+    EngineRef e(h);
+    return e && out ? e->getSpectralDescriptors(out) : 0;
+}
+EXPORT int32_t dsp_drain_onsets(int32_t h, OnsetEvent* out, int32_t capacity) {
+    EngineRef e(h);
+    return e && out ? e->drainOnsets(out, capacity) : 0;
+}
+EXPORT int32_t dsp_get_tempo(int32_t h, TempoStats* out) {
+    EngineRef e(h);
+    if (!e || !out) return 0;
+    e->getTempo(out);
+    return 1;
+}
+EXPORT uint64_t dsp_get_pitch(int32_t h, PitchEstimate* out) {
+    EngineRef e(h);
+    return e && out ? e->getPitch(out) : 0;
+}
+EXPORT uint64_t dsp_get_chroma(int32_t h, float* out) { EngineRef e(h); return e ? e->getChroma(out) : 0; }
+EXPORT int32_t dsp_get_key(int32_t h, float* confidence) { EngineRef e(h); return e ? e->getKey(confidence) : -1; }
+EXPORT int32_t dsp_configure_constant_q(int32_t h, int32_t binsPerOctave, float minHz, float maxHz) {
+    EngineRef e(h);
+    return e ? e->configureConstantQ(binsPerOctave, minHz, maxHz) : 0;
+}
+EXPORT int32_t dsp_get_constant_q(int32_t h, float* out, int32_t capacity, float floorDb, float ceilDb) {
+    EngineRef e(h);
+    return e ? e->getConstantQ(out, capacity, floorDb, ceilDb) : 0;
+}
+EXPORT int32_t dsp_configure_spectrogram(int32_t h, int32_t columns, int32_t rows, float minHz, float maxHz) {
+    EngineRef e(h);
+    return (e && e->configureSpectrogram(columns, rows, minHz, maxHz)) ? 1 : 0;
+}
+EXPORT void dsp_set_spectrogram_colormap(int32_t h, int32_t colormap, float floorDb, float ceilDb) { EngineRef e(h); if (e) e->setSpectrogramColormap(colormap, floorDb, ceilDb); }
+EXPORT void dsp_set_spectrogram_lut(int32_t h, const uint8_t* rgba, float floorDb, float ceilDb) { EngineRef e(h); if (e) e->setSpectrogramLut(rgba, floorDb, ceilDb); }
+EXPORT int32_t dsp_get_spectrogram(int32_t h, SpectrogramView* out) { EngineRef e(h); return (e && e->getSpectrogram(out)) ? 1 : 0; }
+EXPORT void dsp_set_gain(int32_t h, float g) { EngineRef e(h); if (e) e->setMasterGain(g); }
+EXPORT int32_t dsp_submit_commands(int32_t h, const DspCommand* c, int32_t n) { EngineRef e(h); return (e && e->submitCommands(c, n)) ? 1 : 0; }
+EXPORT uint64_t dsp_get_frame_position(int32_t h) { EngineRef e(h); return e ? e->getFramePosition() : 0; }
+EXPORT int32_t dsp_seek(int32_t h, double s) { EngineRef e(h); return (e && e->seek(s)) ? 1 : 0; }
+EXPORT int32_t dsp_switch_source(int32_t h, const char* path, uint64_t frame) { EngineRef e(h); return (e && e->switchSource(path, frame)) ? 1 : 0; }
+EXPORT double dsp_get_media_time(int32_t h) { EngineRef e(h); return e ? e->getCurrentTime() : 0.0; }
+EXPORT void dsp_set_output_latency(int32_t h, double s) { EngineRef e(h); if (e) e->setOutputLatency(s); }
+EXPORT double dsp_get_output_latency(int32_t h) { EngineRef e(h); return e ? e->getOutputLatency() : 0.0; }
+EXPORT void dsp_feed_video_clock(int32_t h, double pts) { EngineRef e(h); if (e) e->feedVideoClock(pts); }
+EXPORT void dsp_set_video_clock_slaving(int32_t h, int32_t on) { EngineRef e(h); if (e) e->setVideoClockSlaving(on != 0); }
+EXPORT int32_t dsp_get_clock_sync_stats(int32_t h, ClockSyncStats* out) {
+    EngineRef e(h);
+    if (!e || !out) return 0;
+    e->getClockSyncStats(out);
+    return 1;
+}
+EXPORT int32_t dsp_get_loudness(int32_t h, LoudnessStats* out) {
+    EngineRef e(h);
+    if (!e || !out) return 0;
+    e->getLoudness(out);
+    return 1;
+}
+EXPORT int32_t dsp_reset_loudness(int32_t h) { EngineRef e(h); return (e && e->resetLoudness()) ? 1 : 0; }
+EXPORT int32_t dsp_get_peaks(int32_t h, PeakStats* out) {
+    EngineRef e(h);
+    if (!e || !out) return 0;
+    e->getPeaks(out);
+    return 1;
+}
+EXPORT int32_t dsp_reset_peaks(int32_t h) { EngineRef e(h); return (e && e->resetPeaks()) ? 1 : 0; }
+EXPORT int32_t dsp_open_subtitle_track(int32_t h) { EngineRef e(h); return e ? e->openSubtitleTrack() : -1; }
+EXPORT void dsp_close_subtitle_track(int32_t h, int32_t t) { EngineRef e(h); if (e) e->closeSubtitleTrack(t); }
+EXPORT void dsp_load_subtitles(int32_t h, int32_t t, const char* s) { EngineRef e(h); if (e && s) e->loadSubtitles(t, s); }
+EXPORT void dsp_load_subtitles_file(int32_t h, int32_t t, const char* path) { EngineRef e(h); if (e && path) e->loadSubtitlesFile(t, path); }
+EXPORT int32_t dsp_get_subtitle_load_status(int32_t h, int32_t t) { EngineRef e(h); return e ? e->getSubtitleLoadStatus(t) : 0; }
+EXPORT int32_t dsp_get_subtitle_index(int32_t h, int32_t t) { EngineRef e(h); return e ? e->getActiveSubtitleIndex(t) : -1; }
+EXPORT int32_t dsp_get_active_subtitles(int32_t h, int32_t t, int32_t* out, int32_t cap) { EngineRef e(h); return e ? e->getActiveSubtitles(t, out, cap) : 0; }
+EXPORT const char* dsp_get_subtitle_text(int32_t h, int32_t t, int32_t i) { EngineRef e(h); return e ? e->getSubtitleText(t, i) : ""; }
+EXPORT int32_t dsp_get_subtitle_cue(int32_t h, int32_t t, int32_t i, SubtitleCueInfo* out) { EngineRef e(h); return (e && e->getSubtitleCue(t, i, out)) ? 1 : 0; }
+EXPORT int32_t dsp_get_subtitle_lookahead(int32_t h, int32_t t, SubtitleCueInfo* out, int32_t n) { EngineRef e(h); return e ? e->getSubtitleLookahead(t, out, n) : 0; }
+EXPORT const char* dsp_get_subtitle_style_name(int32_t h, int32_t t, int32_t id) { EngineRef e(h); return e ? e->getSubtitleStyleName(t, id) : ""; }
+EXPORT int32_t dsp_append_subtitles(int32_t h, int32_t t, const char* s) { EngineRef e(h); return (e && s) ? e->appendSubtitles(t, s) : 0; }
+EXPORT int32_t dsp_amend_last_subtitle(int32_t h, int32_t t, double end, const char* s) { EngineRef e(h); return (e && e->amendLastSubtitle(t, end, s)) ? 1 : 0; }
+EXPORT int32_t dsp_get_all_active_subtitles(int32_t h, SubtitleActiveEntry* out, int32_t cap) { EngineRef e(h); return e ? e->getAllActiveSubtitles(out, cap) : 0; }
+EXPORT uint32_t dsp_get_subtitle_generation(int32_t h) { EngineRef e(h); return e ? e->getSubtitleGeneration() : 0; }
+
+// --- Single-engine exports (default handle) ---
+static int32_t default_handle() { return default_engine.load(std::memory_order_acquire); }
+
+static int32_t ensure_default_handle() {
+    std::lock_guard<std::mutex> lock(default_engine_mutex);
+    if (default_handle() < 0) default_engine.store(dsp_create(), std::memory_order_release);
+    return default_handle();
+}
+
 EXPORT void init_engine(int mode, const char* file_path) {
-    if (!global_engine) global_engine = new DSPEngine();
     // اگر فایل پث نال باشه و مد ۱ باشه، ارور میده داخلی ولی کرش نمیکنه
-    global_engine->start(mode, file_path);
+    dsp_start(ensure_default_handle(), mode, file_path);
 }
+EXPORT uint32_t start_engine_async(int mode, const char* file_path) { return dsp_start_async(ensure_default_handle(), mode, file_path); }
+EXPORT int32_t get_start_report(StartReport* out) { return dsp_get_start_report(default_handle(), out); }
 EXPORT void stop_engine() {
-    if (global_engine) { global_engine->stop(); delete global_engine; global_engine = nullptr; }
-}
-EXPORT float get_rms_level() { return global_engine ? global_engine->getRms() : 0.0f; }
-EXPORT float* get_fft_array() { return global_engine ? global_engine->getFftData() : nullptr; }
-EXPORT void set_gain(float g) { if (global_engine) global_engine->setMasterGain(g); }
-EXPORT void load_subtitles(const char* s) { if (global_engine) global_engine->loadSubtitles(s); }
-EXPORT int32_t get_subtitle_index() { return global_engine ? global_engine->getActiveSubtitleIndex() : -1; }
-EXPORT const char* get_subtitle_text(int32_t i) { return global_engine ? global_engine->getSubtitleText(i) : ""; }
-EXPORT double get_media_time() { return global_engine ? global_engine->getCurrentTime() : 0.0; }
\ No newline at end of file
+    std::lock_guard<std::mutex> lock(default_engine_mutex);
+    int32_t h = default_engine.exchange(-1, std::memory_order_acq_rel);
+    dsp_stop(h);
+    dsp_destroy(h); // Freed once in-flight getters return
+}
+EXPORT void pause_engine() { dsp_pause(default_handle()); }
+EXPORT int32_t resume_engine() { return dsp_resume(default_handle()); }
+EXPORT float get_rms_level() { return dsp_get_rms_level(default_handle()); }
+EXPORT float* get_fft_array() { return dsp_get_fft_array(default_handle()); }
+EXPORT int32_t get_spectrum_bands(float* out, int32_t count, float minHz, float maxHz, float floorDb, float ceilDb) {
+    return dsp_get_spectrum_bands(default_handle(), out, count, minHz, maxHz, floorDb, ceilDb);
+}
+EXPORT uint64_t get_mel_features(float* mel, float* mfcc) { return dsp_get_mel_features(default_handle(), mel, mfcc); }
+EXPORT uint64_t get_spectral_descriptors(SpectralDescriptors* out) { return dsp_get_spectral_descriptors(default_handle(), out); }
+EXPORT int32_t drain_onsets(OnsetEvent* out, int32_t capacity) { return dsp_drain_onsets(default_handle(), out, capacity); }
+EXPORT int32_t get_tempo(TempoStats* out) { return dsp_get_tempo(default_handle(), out); }
+EXPORT uint64_t get_pitch(PitchEstimate* out) { return dsp_get_pitch(default_handle(), out); }
+EXPORT uint64_t get_chroma(float* out) { return dsp_get_chroma(default_handle(), out); }
+EXPORT int32_t get_key(float* confidence) { return dsp_get_key(default_handle(), confidence); }
+EXPORT int32_t configure_constant_q(int32_t binsPerOctave, float minHz, float maxHz) {
+    return dsp_configure_constant_q(default_handle(), binsPerOctave, minHz, maxHz);
+}
+EXPORT int32_t get_constant_q(float* out, int32_t capacity, float floorDb, float ceilDb) {
+    return dsp_get_constant_q(default_handle(), out, capacity, floorDb, ceilDb);
+}
+EXPORT int32_t configure_spectrogram(int32_t columns, int32_t rows, float minHz, float maxHz) {
+    return dsp_configure_spectrogram(default_handle(), columns, rows, minHz, maxHz);
+}
+EXPORT void set_spectrogram_colormap(int32_t colormap, float floorDb, float ceilDb) { dsp_set_spectrogram_colormap(default_handle(), colormap, floorDb, ceilDb); }
+EXPORT int32_t get_spectrogram(SpectrogramView* out) { return dsp_get_spectrogram(default_handle(), out); }
+EXPORT void set_gain(float g) { dsp_set_gain(default_handle(), g); }
+EXPORT int32_t seek_engine(double s) { return dsp_seek(default_handle(), s); }
+EXPORT void load_subtitles(const char* s) { dsp_load_subtitles(default_handle(), 0, s); }
+EXPORT void load_subtitles_file(const char* path) { dsp_load_subtitles_file(default_handle(), 0, path); }
+EXPORT int32_t get_subtitle_load_status() { return dsp_get_subtitle_load_status(default_handle(), 0); }
+EXPORT int32_t get_subtitle_index() { return dsp_get_subtitle_index(default_handle(), 0); }
+EXPORT int32_t get_active_subtitles(int32_t* out, int32_t cap) { return dsp_get_active_subtitles(default_handle(), 0, out, cap); }
+EXPORT const char* get_subtitle_text(int32_t i) { return dsp_get_subtitle_text(default_handle(), 0, i); }
+EXPORT int32_t get_subtitle_cue(int32_t i, SubtitleCueInfo* out) { return dsp_get_subtitle_cue(default_handle(), 0, i, out); }
+EXPORT const char* get_subtitle_style_name(int32_t id) { return dsp_get_subtitle_style_name(default_handle(), 0, id); }
+EXPORT int32_t get_subtitle_lookahead(SubtitleCueInfo* out, int32_t n) { return dsp_get_subtitle_lookahead(default_handle(), 0, out, n); }
+EXPORT int32_t open_subtitle_track() { return dsp_open_subtitle_track(default_handle()); }
+EXPORT void close_subtitle_track(int32_t t) { dsp_close_subtitle_track(default_handle(), t); }
+EXPORT void load_track_subtitles(int32_t t, const char* s) { dsp_load_subtitles(default_handle(), t, s); }
+EXPORT void load_track_subtitles_file(int32_t t, const char* path) { dsp_load_subtitles_file(default_handle(), t, path); }
+EXPORT int32_t get_track_load_status(int32_t t) { return dsp_get_subtitle_load_status(default_handle(), t); }
+EXPORT int32_t get_track_active_subtitles(int32_t t, int32_t* out, int32_t cap) { return dsp_get_active_subtitles(default_handle(), t, out, cap); }
+EXPORT const char* get_track_subtitle_text(int32_t t, int32_t i) { return dsp_get_subtitle_text(default_handle(), t, i); }
+EXPORT int32_t get_track_subtitle_cue(int32_t t, int32_t i, SubtitleCueInfo* out) { return dsp_get_subtitle_cue(default_handle(), t, i, out); }
+EXPORT int32_t get_track_subtitle_lookahead(int32_t t, SubtitleCueInfo* out, int32_t n) { return dsp_get_subtitle_lookahead(default_handle(), t, out, n); }
+EXPORT const char* get_track_subtitle_style_name(int32_t t, int32_t id) { return dsp_get_subtitle_style_name(default_handle(), t, id); }
+EXPORT int32_t append_track_subtitles(int32_t t, const char* s) { return dsp_append_subtitles(default_handle(), t, s); }
+EXPORT int32_t amend_track_last_subtitle(int32_t t, double end, const char* s) { return dsp_amend_last_subtitle(default_handle(), t, end, s); }
+EXPORT int32_t get_all_active_subtitles(SubtitleActiveEntry* out, int32_t cap) { return dsp_get_all_active_subtitles(default_handle(), out, cap); }
+EXPORT uint32_t get_subtitle_generation() { return dsp_get_subtitle_generation(default_handle()); }
+EXPORT double get_media_time() { return dsp_get_media_time(default_handle()); }
+EXPORT void set_output_latency(double s) { dsp_set_output_latency(default_handle(), s); }
+EXPORT double get_output_latency() { return dsp_get_output_latency(default_handle()); }
+EXPORT void feed_video_clock(double pts) { dsp_feed_video_clock(default_handle(), pts); }
+EXPORT void set_video_clock_slaving(int32_t on) { dsp_set_video_clock_slaving(default_handle(), on); }
+EXPORT int32_t get_clock_sync_stats(ClockSyncStats* out) { return dsp_get_clock_sync_stats(default_handle(), out); }
+EXPORT int32_t get_loudness(LoudnessStats* out) { return dsp_get_loudness(default_handle(), out); }
+EXPORT int32_t reset_loudness() { return dsp_reset_loudness(default_handle()); }
+EXPORT int32_t get_peaks(PeakStats* out) { return dsp_get_peaks(default_handle(), out); }
+EXPORT int32_t reset_peaks() { return dsp_reset_peaks(default_handle()); }
@@ -5,10 +5,30 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "subtitles.h"
+#include "media_clock.h"
+#include "clock_sync.h"
+#include "spsc_queue.h"
+#include "snapshot.h"
+#include "spectrum.h"
+#include "spectrogram.h"
+#include "fft.h"
+#include "cqt.h"
+#include "chroma.h"
+#include "loudness.h"
+#include "true_peak.h"
+#include "descriptors.h"
+#include "onset.h"
+#include "tempo.h"
+#include "pitch.h"
 
 // Forward Declarations
 struct ma_device;
 struct ma_decoder; // اضافه شده برای خواندن فایل
+struct PlaybackResampler;
 
 #if defined(_WIN32)
     #define EXPORT extern "C" __declspec(dllexport)
@@ -19,6 +39,15 @@ struct ma_decoder; // اضافه شده برای خواندن فایل
 #define FFT_SIZE 1024
 #define FFT_BINS (FFT_SIZE / 2)
 #define SAMPLE_RATE 48000
+#define MAX_SPECTRUM_BANDS 512
+#define MEL_BANDS 40
+#define MFCC_COEFFS 13
+#define MEL_MIN_HZ 20.0f
+#define MEL_MAX_HZ 16000.0f
+#define CQT_FFT_SIZE 16384      // 341 ms: 12 bins/octave reach down to ~50 Hz at full Q
+#define MAX_CQT_BINS 512
+#define ANALYSIS_HISTORY 32768  // Samples kept for the long analysis windows
+#define CHROMA_FFT_SIZE 4096    // 11.7 Hz bins: chord tones resolve above ~200 Hz
 
 // حالت‌های موتور
 enum class EngineMode {
@@ -27,10 +56,63 @@ enum class EngineMode {
     PLAYBACK = 1 // پخش فایل (Video Player Sync)
 };
 
-struct SubtitleEvent {
-    double startTime;
-    double endTime;
-    std::string text;
+// Video clock slaving: AUTO switches ON at the first fed frame, an explicit
+// setVideoClockSlaving choice sticks until the next stop
+enum class VideoSlaving : int32_t {
+    AUTO = 0,
+    ON = 1,
+    OFF = 2
+};
+
+// Parameter changes travel to the audio thread as timestamped commands
+enum class CommandType : int32_t {
+    SET_GAIN = 0,       // value = linear gain
+    SEEK = 1,           // value = media time in seconds (PLAYBACK)
+    SET_DC_BLOCKER = 2, // value = DC-blocker pole, e.g. 0.995
+    SWITCH_SOURCE = 3,  // Internal: submitted through switchSource()
+    RESET_LOUDNESS = 4, // Restarts integrated loudness and LRA (value unused)
+    RESET_PEAKS = 5     // Clears peak holds and maxima (value unused)
+};
+
+// FFI view of one command (layout mirrored in lib/ffi_bridge.dart). `frame`
+// is the engine frame (getFramePosition) the command lands on; frames
+// already played apply at the start of the next callback.
+struct DspCommand {
+    int32_t type;
+    uint64_t frame;
+    double value;
+};
+
+// Why a start failed (StartReport::error)
+enum class StartError : int32_t {
+    NONE = 0,
+    NO_FILE = 1,             // PLAYBACK without a path
+    DECODER_FAILED = 2,
+    RESAMPLER_FAILED = 3,
+    DEVICE_INIT_FAILED = 4,
+    DEVICE_START_FAILED = 5,
+    ALREADY_RUNNING = 6,
+    CANCELLED = 7,           // Stopped before the start took effect
+    INVALID_HANDLE = 8       // dsp_start on a destroyed or unknown handle
+};
+
+enum class StartState : int32_t {
+    FAILED = -1,
+    IDLE = 0,
+    STARTING = 1,
+    RUNNING = 2
+};
+
+// FFI view of the last start request (layout mirrored in lib/ffi_bridge.dart)
+struct StartReport {
+    uint32_t ticket;       // Request this report belongs to
+    int32_t state;         // StartState
+    int32_t error;         // StartError
+    int32_t backendResult; // miniaudio result of the failing call, 0 on success
+    double decoderOpenMs;
+    double deviceInitMs;   // 0 when a cached device was reused
+    double deviceStartMs;
+    double totalMs;        // From the request to a running stream, queueing included
 };
 
 class DSPEngine {
@@ -39,58 +121,419 @@ public:
     ~DSPEngine();
 
     // تغییر: حالا init مد و مسیر فایل رو میگیره
-    void start(int mode, const char* filePath = nullptr);
-    void stop();
+    StartError start(int mode, const char* filePath = nullptr);
+    // Opens the decoder and device on a worker thread; poll getStartReport()
+    // with the returned ticket. A request still queued is replaced by a newer one.
+    uint32_t startAsync(int mode, const char* filePath);
+    void getStartReport(StartReport* out);
+    void stop(); // Stops the stream; the device stays cached for the next start
+    // Stops the stream without releasing anything; resume continues where it left off
+    void pause();
+    // False when the device would not restart; the engine then stays paused
+    bool resume();
+    bool paused() const { return isPaused.load(); }
 
     float getRms();
     float* getFftData();
+    // Latest FFT frame folded into `count` log-spaced bands (minHz..maxHz),
+    // converted to dB and mapped so floorDb..ceilDb spans 0..1. Returns the
+    // number of bands written, 0 for an invalid range.
+    int32_t getSpectrumBands(float* out, int32_t count, float minHz, float maxHz, float floorDb, float ceilDb);
+
+    // Log-mel energies (MEL_BANDS, natural log) and MFCCs (MFCC_COEFFS) of
+    // the latest FFT hop, read as one consistent frame. Either output may be
+    // null. Returns the hop number, 0 before the first one.
+    uint64_t getMelFeatures(float* mel, float* mfcc) const;
+    // Centroid, rolloff, flatness, flux and crest of the same hop, computed
+    // on the audio thread; returns the hop number, 0 before the first one
+    uint64_t getSpectralDescriptors(SpectralDescriptors* out) const;
+    // Onsets detected since the last drain, oldest first, one hop (21 ms)
+    // after they happen; times are content positions on the media clock.
+    // Returns the number copied; any left over stay queued.
+    int32_t drainOnsets(OnsetEvent* out, int32_t capacity);
+    // Tempo and beat grid tracked on the onset envelope; the phase and next
+    // beat are evaluated against the media clock at the time of the call
+    void getTempo(TempoStats* out) const;
+    // CAPTURE only: YIN pitch of the input, every PitchTracker::HOP samples.
+    // Returns the hop number, 0 before the first one.
+    uint64_t getPitch(PitchEstimate* out) const;
+
+    // PLAYBACK only: smoothed 12-bin chroma (C first, max-normalized) of the
+    // latest hop; returns the hop number. getKey returns 0..11 for C..B
+    // major, 12..23 for C..B minor, -1 while unknown.
+    uint64_t getChroma(float* out) const;
+    int32_t getKey(float* confidence) const;
+
+    // Constant-Q magnitudes over the newest CQT_FFT_SIZE samples, bin k at
+    // minHz * 2^(k / binsPerOctave). Configure returns the bin count (0 when
+    // invalid) and starts recording the analysis history; get returns the
+    // bins written, in normalized dB like getSpectrumBands.
+    int32_t configureConstantQ(int32_t binsPerOctave, float minHz, float maxHz);
+    int32_t getConstantQ(float* out, int32_t capacity, float floorDb, float ceilDb);
+
+    // Waterfall: the history ring keeps the last `columns` spectra (K). It is
+    // allocated on the first configure, regrown when a wider image is asked
+    // for, and records every FFT frame from then on. getSpectrogram draws the
+    // frames recorded since the last call; the pixel pointer stays valid
+    // until the next configure.
+    bool configureSpectrogram(int32_t columns, int32_t rows, float minHz, float maxHz);
+    void setSpectrogramColormap(int32_t colormap, float floorDb, float ceilDb);
+    void setSpectrogramLut(const uint8_t* rgba, float floorDb, float ceilDb);
+    bool getSpectrogram(SpectrogramView* out);
     double getCurrentTime() const; // Works for both Mic and File
+    // Seconds subtracted from the clock; negative restores the device-reported value
+    void setOutputLatency(double seconds);
+    double getOutputLatency() const;
+
+    // External video clock: each presented frame's timestamp steers the
+    // playback rate so the audio clock follows the video instead of drifting.
+    // The first feed after a start enables slaving unless it was set explicitly.
+    void feedVideoClock(double pts);
+    void setVideoClockSlaving(bool enabled);
+    void getClockSyncStats(ClockSyncStats* out) const;
 
+    // EBU R128 loudness of the post-gain signal, updated every 100 ms.
+    // Integrated loudness and LRA cover everything since start or the last
+    // reset (which lands sample-accurately through the command queue).
+    void getLoudness(LoudnessStats* out) const;
+    // False when the command queue is full; applied at once while stopped or paused
+    bool resetLoudness();
+    // Sample and true peak (BS.1770 Annex 2) of the same signal, with decay
+    // and hold ballistics, published once per callback
+    void getPeaks(PeakStats* out) const;
+    bool resetPeaks();
+
+    // Latest value wins: the callback ramps to it, nothing is queued
     void setMasterGain(float gain);
-    void loadSubtitles(const char* srtContent);
-    int32_t getActiveSubtitleIndex() const;
-    const char* getSubtitleText(int32_t index) const;
+
+    // Queues commands for the audio thread. A batch lands together: all of it
+    // or none (false when the queue is full). Commands apply in submission
+    // order, each at the first callback frame >= its `frame`. While paused
+    // nothing is drained; stop applies what is left immediately.
+    bool submitCommands(const DspCommand* commands, int32_t count);
+    bool seek(double seconds, uint64_t frame = 0);
+    // Opens the file on the calling thread, then swaps it in at `frame`
+    bool switchSource(const char* filePath, uint64_t frame = 0);
+    uint64_t getFramePosition() const; // Device frames since start
+
+    // Subtitle tracks (handle 0 is the default track)
+    int32_t openSubtitleTrack();
+    void closeSubtitleTrack(int32_t track);
+    void loadSubtitles(int32_t track, const char* content); // SRT, WebVTT or ASS/SSA
+    void loadSubtitlesFile(int32_t track, const char* path);
+    int32_t getSubtitleLoadStatus(int32_t track) const;
+    int32_t getActiveSubtitleIndex(int32_t track) const;
+    int32_t getActiveSubtitles(int32_t track, int32_t* out, int32_t capacity) const;
+    int32_t getAllActiveSubtitles(SubtitleActiveEntry* out, int32_t capacity) const;
+    uint32_t getSubtitleGeneration() const;
+    const char* getSubtitleText(int32_t track, int32_t index) const;
+    bool getSubtitleCue(int32_t track, int32_t index, SubtitleCueInfo* out) const;
+    int32_t getSubtitleLookahead(int32_t track, SubtitleCueInfo* out, int32_t count) const;
+    const char* getSubtitleStyleName(int32_t track, int32_t styleId) const;
+    int32_t appendSubtitles(int32_t track, const char* content);
+    bool amendLastSubtitle(int32_t track, double endTime, const char* text);
 
     // متدی که Miniaudio صدا میزنه
     void onAudioData(void* pOutput, const void* pInput, uint32_t frameCount);
 
 private:
+    std::mutex lifecycleMutex; // Serializes start/stop from different callers
     std::atomic<bool> isRunning;
+    std::atomic<bool> isPaused;
     EngineMode currentMode;
+    EngineMode deviceMode; // Direction of the cached device
 
     ma_device* device;
     ma_decoder* decoder; // دیکدر فایل صوتی
 
     std::atomic<uint64_t> totalFramesProcessed;
-    std::atomic<float> masterGain;
+    MediaClock mediaClock;
+    std::atomic<double> latencyOverride; // < 0: use reportedLatency
+    double reportedLatency;
+    VideoClockSync videoSync;
+    std::atomic<int32_t> videoSlaving; // VideoSlaving
+    PlaybackResampler* resampler; // PLAYBACK only; engaged while slaving
+    bool resamplerEngaged;        // Audio thread
+    uint64_t contentFrames;       // Decoded frames consumed (audio thread)
     std::atomic<float> currentRms;
 
-    std::vector<SubtitleEvent> subtitles;
-    std::atomic<int32_t> currentSubtitleIdx;
+    // Audio-thread parameters, changed only through `commands`
+    static constexpr uint32_t COMMAND_CAPACITY = 64;
+    static constexpr uint32_t ONSET_CAPACITY = 256; // Events kept for a slow reader
+    struct EngineCommand {
+        CommandType type;
+        uint64_t frame;
+        double value;
+        ma_decoder* decoder; // SWITCH_SOURCE
+    };
+    SpscQueue<EngineCommand, COMMAND_CAPACITY> commands;
+    SpscQueue<ma_decoder*, COMMAND_CAPACITY> retiredDecoders; // Audio thread -> producers
+    std::mutex commandMutex; // Serializes producers; the audio side never locks
+    std::atomic<bool> clockJumped; // Seek or source switch, for the scheduler
+    std::atomic<float> gainTarget; // setMasterGain, read once per callback
+    float masterGain;     // Target the ramp is heading to (audio thread)
+    float rampGain;       // Gain reached so far
+    float rampStep;       // Per-frame increment while ramping
+    uint32_t rampFramesLeft;
+
+    SubtitleTrackSet subtitles;
+
+    // Subtitle scheduler: syncs tracks off the audio thread, sleeping until
+    // the media clock reaches the next cue boundary
+    std::thread subtitleScheduler;
+    std::mutex schedulerMutex;
+    std::condition_variable schedulerWake;
+    bool schedulerExit;
+    bool schedulerKicked;
+
+    // Async start worker (created on first use)
+    std::thread starter;
+    std::mutex starterMutex;
+    std::condition_variable starterWake;
+    bool starterExit;
+    bool hasPendingStart;
+    int pendingMode;
+    bool pendingHasPath;
+    std::string pendingPath;
+    int64_t pendingRequestTime;
+    uint32_t startTicket;
+    StartReport lastReport; // Guarded by starterMutex
+    // Bumped by stop() under starterMutex; a start whose generation moved
+    // before it took lifecycleMutex is cancelled instead of run
+    std::atomic<uint32_t> stopGeneration;
 
     float prevInput;
     float prevOutput;
-    const float R = 0.995f;
+    float R; // DC-blocker pole
 
     float sampleBuffer[FFT_SIZE];
     int bufferIndex;
     float fftMagnitudes[FFT_BINS];
+    FftPlan fftPlan;
+    std::vector<float> fftWindow;
+    FrameSnapshot<FFT_BINS> spectrum; // Magnitudes, published once per FFT
+    DescriptorExtractor descriptors; // Audio thread
+    FrameSnapshot<sizeof(SpectralDescriptors) / sizeof(float)> descriptorFrame;
+    double fftFramePosition; // Content frame of sampleBuffer[0]
+    double fftFrameRate;     // Content frames per sample in that frame
+    OnsetDetector onsets; // Audio thread
+    SpscQueue<OnsetEvent, ONSET_CAPACITY> onsetEvents; // Audio thread -> drainOnsets
+    std::mutex onsetMutex; // Serializes consumers
+    TempoTracker tempo; // Audio thread
+    FrameSnapshot<4, double> tempoFrame; // BPM, confidence, period and last beat in seconds
+    BandMatrix melFilters;
+    DctTable mfccDct;
+    FrameSnapshot<MEL_BANDS + MFCC_COEFFS> melFeatures; // Log-mel, then MFCCs
+
+    // Level meters on the post-gain signal, published for any reader
+    LoudnessMeter loudness; // Audio thread
+    FrameSnapshot<sizeof(LoudnessStats) / sizeof(double), double> loudnessFrame;
+    TruePeakMeter peakMeter; // Audio thread
+    FrameSnapshot<sizeof(PeakStats) / sizeof(double), double> peakFrame;
+
+    PitchTracker pitch; // Audio thread, shares fftPlan
+    FrameSnapshot<sizeof(PitchEstimate) / sizeof(float)> pitchFrame;
+
+    // Chroma runs on a longer frame from the analysis history, audio thread only
+    ChromaTracker chromaTracker;
+    FftPlan chromaPlan;
+    std::vector<float> chromaWindow;
+    std::vector<float> chromaSamples;
+    std::vector<std::complex<float>> chromaSpectrum;
+    FrameSnapshot<ChromaTracker::PITCH_CLASSES + 2> chromaFrame; // Chroma, key, confidence
+
+    // Band map cache for getSpectrumBands, rebuilt when the layout changes
+    std::mutex bandMutex;
+    BandMatrix bandMap;
+    int32_t bandCount;
+    float bandMinHz;
+    float bandMaxHz;
+
+    // Filtered input history for analyses longer than one FFT frame
+    std::mutex analysisMutex;
+    std::unique_ptr<SampleRing> analysisStorage;
+    std::atomic<SampleRing*> analysisHistory; // Null until a consumer asks for it
+
+    std::mutex cqtMutex;
+    std::unique_ptr<ConstantQ> constantQ;
+    std::vector<float> cqtFrame;
+
+    std::unique_ptr<SpectrogramHistory> spectrogramStorage;
+    std::atomic<SpectrogramHistory*> spectrogram; // Null until configured
+    std::vector<std::unique_ptr<SpectrogramHistory>> retiredSpectrograms; // Outgrown, maybe still written
+    std::mutex spectrogramMutex; // Guards the raster
+    SpectrogramRaster spectrogramRaster;
 
     void computeFFT();
-    void syncSubtitles(double timestamp);
-    void processSignal(const float* buffer, uint32_t frames);
+    void computeChroma(SampleRing& history);
+    SampleRing* enableAnalysisHistory();
+    bool pushCommands(const EngineCommand* batch, uint32_t count);
+    bool applyCommands(uint64_t frame);
+    void rampGainTo(float target);
+    void publishLoudness();
+    void publishPeaks();
+    void freeRetiredDecoders();
+    uint64_t renderPlayback(float* out, uint32_t frameCount);
+    // `position` is the content frame of buffer[0], `rate` content frames
+    // per device frame. Returns the sum of squares.
+    float processSignal(const float* buffer, uint32_t frames, double position, double rate);
+    uint64_t readResampled(float* out, uint32_t frameCount);
+    StartError startStream(int mode, const char* filePath, StartReport& report, uint32_t generation);
+    void cancelPendingStart();
+    void starterLoop();
+    int32_t openDevice(EngineMode mode);
+    void releaseDevice();
+    void releasePlaybackSource();
+    void applyLatency();
+    void runSubtitleScheduler();
+    void wakeSubtitleScheduler();
 };
 
 // --- FFI Exports ---
+// Handle API: every engine is an independent stream. Handles are > 0; calls
+// with a destroyed or unknown handle are ignored and return defaults. An
+// engine is freed when its last owner destroys it and no call is still
+// running inside it. Returned pointers (FFT array, subtitle texts and style
+// names) stay valid until the engine is destroyed: reloading or closing a
+// subtitle track retires its table without freeing it.
+EXPORT int32_t dsp_create(); // -1 when MAX_ENGINES are alive
+EXPORT int32_t dsp_retain(int32_t handle); // Extra owner, released by dsp_destroy
+EXPORT void dsp_destroy(int32_t handle);
+EXPORT int32_t dsp_start(int32_t handle, int mode, const char* file_path); // StartError
+// Non-blocking start: returns a ticket; poll dsp_get_start_report until its
+// state leaves STARTING
+EXPORT uint32_t dsp_start_async(int32_t handle, int mode, const char* file_path);
+EXPORT int32_t dsp_get_start_report(int32_t handle, StartReport* out_report);
+EXPORT void dsp_stop(int32_t handle); // The device stays cached: the next start is warm
+EXPORT void dsp_pause(int32_t handle); // Stops the stream, keeps device, decoder and position
+EXPORT int32_t dsp_resume(int32_t handle); // 1 when the stream is running afterwards
+EXPORT int32_t dsp_is_paused(int32_t handle);
+EXPORT float dsp_get_rms_level(int32_t handle);
+EXPORT float* dsp_get_fft_array(int32_t handle);
+// Log-frequency bands of the latest FFT frame, normalized dB in [0, 1];
+// returns the number written (count <= MAX_SPECTRUM_BANDS)
+EXPORT int32_t dsp_get_spectrum_bands(int32_t handle, float* out_bands, int32_t count,
+                                      float min_hz, float max_hz, float floor_db, float ceil_db);
+// Log-mel energies and MFCCs of the latest FFT hop (MEL_BANDS / MFCC_COEFFS
+// floats, either pointer may be null); returns the hop number
+EXPORT uint64_t dsp_get_mel_features(int32_t handle, float* out_mel, float* out_mfcc);
+// Spectral descriptors of the latest FFT hop; returns the hop number
+EXPORT uint64_t dsp_get_spectral_descriptors(int32_t handle, SpectralDescriptors* out_descriptors);
+// Pops up to `capacity` queued onsets (oldest first); returns the number written
+EXPORT int32_t dsp_drain_onsets(int32_t handle, OnsetEvent* out_events, int32_t capacity);
+EXPORT int32_t dsp_get_tempo(int32_t handle, TempoStats* out_stats);
+// Microphone pitch (CAPTURE mode); returns the hop number
+EXPORT uint64_t dsp_get_pitch(int32_t handle, PitchEstimate* out_pitch);
+// Chroma and key of the playing file, see DSPEngine::getChroma / getKey
+EXPORT uint64_t dsp_get_chroma(int32_t handle, float* out_chroma); // 12 floats
+EXPORT int32_t dsp_get_key(int32_t handle, float* out_confidence);
+// Constant-Q transform: configure returns the bin count (<= MAX_CQT_BINS),
+// get writes normalized dB magnitudes and returns the number written
+EXPORT int32_t dsp_configure_constant_q(int32_t handle, int32_t bins_per_octave, float min_hz, float max_hz);
+EXPORT int32_t dsp_get_constant_q(int32_t handle, float* out_bins, int32_t capacity, float floor_db, float ceil_db);
+// Scrolling waterfall texture; see SpectrogramView for how to draw the ring
+EXPORT int32_t dsp_configure_spectrogram(int32_t handle, int32_t columns, int32_t rows, float min_hz, float max_hz);
+EXPORT void dsp_set_spectrogram_colormap(int32_t handle, int32_t colormap, float floor_db, float ceil_db);
+EXPORT void dsp_set_spectrogram_lut(int32_t handle, const uint8_t* rgba_256, float floor_db, float ceil_db);
+EXPORT int32_t dsp_get_spectrogram(int32_t handle, SpectrogramView* out_view); // 0 until configured
+EXPORT void dsp_set_gain(int32_t handle, float gain);
+// Sample-accurate parameter changes, see DSPEngine::submitCommands
+EXPORT int32_t dsp_submit_commands(int32_t handle, const DspCommand* commands, int32_t count);
+EXPORT uint64_t dsp_get_frame_position(int32_t handle);
+EXPORT int32_t dsp_seek(int32_t handle, double seconds);
+EXPORT int32_t dsp_switch_source(int32_t handle, const char* file_path, uint64_t frame);
+EXPORT double dsp_get_media_time(int32_t handle);
+EXPORT void dsp_set_output_latency(int32_t handle, double seconds);
+EXPORT double dsp_get_output_latency(int32_t handle);
+EXPORT void dsp_feed_video_clock(int32_t handle, double pts);
+EXPORT void dsp_set_video_clock_slaving(int32_t handle, int32_t enabled);
+EXPORT int32_t dsp_get_clock_sync_stats(int32_t handle, ClockSyncStats* out_stats);
+EXPORT int32_t dsp_get_loudness(int32_t handle, LoudnessStats* out_stats);
+EXPORT int32_t dsp_reset_loudness(int32_t handle); // 0 when the command queue is full
+EXPORT int32_t dsp_get_peaks(int32_t handle, PeakStats* out_stats);
+EXPORT int32_t dsp_reset_peaks(int32_t handle);
+EXPORT int32_t dsp_open_subtitle_track(int32_t handle);
+EXPORT void dsp_close_subtitle_track(int32_t handle, int32_t track);
+EXPORT void dsp_load_subtitles(int32_t handle, int32_t track, const char* data);
+EXPORT void dsp_load_subtitles_file(int32_t handle, int32_t track, const char* path);
+EXPORT int32_t dsp_get_subtitle_load_status(int32_t handle, int32_t track);
+EXPORT int32_t dsp_get_subtitle_index(int32_t handle, int32_t track);
+EXPORT int32_t dsp_get_active_subtitles(int32_t handle, int32_t track, int32_t* out_indices, int32_t capacity);
+EXPORT const char* dsp_get_subtitle_text(int32_t handle, int32_t track, int32_t index);
+EXPORT int32_t dsp_get_subtitle_cue(int32_t handle, int32_t track, int32_t index, SubtitleCueInfo* out_cue);
+EXPORT int32_t dsp_get_subtitle_lookahead(int32_t handle, int32_t track, SubtitleCueInfo* out_cues, int32_t count);
+EXPORT const char* dsp_get_subtitle_style_name(int32_t handle, int32_t track, int32_t style_id);
+EXPORT int32_t dsp_append_subtitles(int32_t handle, int32_t track, const char* data);
+EXPORT int32_t dsp_amend_last_subtitle(int32_t handle, int32_t track, double end_time, const char* text);
+EXPORT int32_t dsp_get_all_active_subtitles(int32_t handle, SubtitleActiveEntry* out_entries, int32_t capacity);
+EXPORT uint32_t dsp_get_subtitle_generation(int32_t handle);
+
+// Single-engine API, kept for existing callers: drives one default engine
+// created by init_engine and destroyed by stop_engine.
 // تغییر: ورودی‌های جدید برای init
 EXPORT void init_engine(int mode, const char* file_path);
 EXPORT void stop_engine();
+EXPORT uint32_t start_engine_async(int mode, const char* file_path);
+EXPORT int32_t get_start_report(StartReport* out_report);
+EXPORT void pause_engine();
+EXPORT int32_t resume_engine();
 EXPORT float get_rms_level();
 EXPORT float* get_fft_array();
+EXPORT int32_t get_spectrum_bands(float* out_bands, int32_t count, float min_hz, float max_hz, float floor_db, float ceil_db);
+EXPORT uint64_t get_mel_features(float* out_mel, float* out_mfcc);
+EXPORT uint64_t get_spectral_descriptors(SpectralDescriptors* out_descriptors);
+EXPORT int32_t drain_onsets(OnsetEvent* out_events, int32_t capacity);
+EXPORT int32_t get_tempo(TempoStats* out_stats);
+EXPORT uint64_t get_pitch(PitchEstimate* out_pitch);
+EXPORT uint64_t get_chroma(float* out_chroma);
+EXPORT int32_t get_key(float* out_confidence);
+EXPORT int32_t configure_constant_q(int32_t bins_per_octave, float min_hz, float max_hz);
+EXPORT int32_t get_constant_q(float* out_bins, int32_t capacity, float floor_db, float ceil_db);
+EXPORT int32_t configure_spectrogram(int32_t columns, int32_t rows, float min_hz, float max_hz);
+EXPORT void set_spectrogram_colormap(int32_t colormap, float floor_db, float ceil_db);
+EXPORT int32_t get_spectrogram(SpectrogramView* out_view);
 EXPORT void set_gain(float gain);
+EXPORT int32_t seek_engine(double seconds);
 EXPORT void load_subtitles(const char* srt_data);
+EXPORT void load_subtitles_file(const char* path);
+EXPORT int32_t get_subtitle_load_status(); // -1 failed, 0 idle, 1 loading, 2 ready
 EXPORT int32_t get_subtitle_index();
+EXPORT int32_t get_active_subtitles(int32_t* out_indices, int32_t capacity);
 EXPORT const char* get_subtitle_text(int32_t index);
-EXPORT double get_media_time();
+EXPORT int32_t get_subtitle_cue(int32_t index, SubtitleCueInfo* out_cue);
+EXPORT const char* get_subtitle_style_name(int32_t style_id);
+// Next `count` cues starting after the current media time, for pre-layout
+EXPORT int32_t get_subtitle_lookahead(SubtitleCueInfo* out_cues, int32_t count);
+
+// Multi-track subtitles: poll get_subtitle_generation() once per frame and
+// only re-read the active cues (of all tracks at once) when it moved.
+EXPORT int32_t open_subtitle_track();
+EXPORT void close_subtitle_track(int32_t track);
+EXPORT void load_track_subtitles(int32_t track, const char* data);
+EXPORT void load_track_subtitles_file(int32_t track, const char* path);
+EXPORT int32_t get_track_load_status(int32_t track);
+EXPORT int32_t get_track_active_subtitles(int32_t track, int32_t* out_indices, int32_t capacity);
+EXPORT const char* get_track_subtitle_text(int32_t track, int32_t index);
+EXPORT int32_t get_track_subtitle_cue(int32_t track, int32_t index, SubtitleCueInfo* out_cue);
+EXPORT int32_t get_track_subtitle_lookahead(int32_t track, SubtitleCueInfo* out_cues, int32_t count);
+EXPORT const char* get_track_subtitle_style_name(int32_t track, int32_t style_id);
+// Live captions: append cue fragments without reloading; amend the newest cue
+// in place (end_time < 0 keeps the end, text == NULL keeps the text)
+EXPORT int32_t append_track_subtitles(int32_t track, const char* data);
+EXPORT int32_t amend_track_last_subtitle(int32_t track, double end_time, const char* text);
+EXPORT int32_t get_all_active_subtitles(SubtitleActiveEntry* out_entries, int32_t capacity);
+EXPORT uint32_t get_subtitle_generation();
+EXPORT double get_media_time(); // Interpolated between callbacks, latency compensated
+EXPORT void set_output_latency(double seconds); // Measured latency; < 0 reverts to reported
+EXPORT double get_output_latency();
+// Video slaving: call with the PTS of every frame as it is presented. Slaving
+// starts on the first timestamp; resyncNeeded asks the player to seek.
+EXPORT void feed_video_clock(double pts);
+EXPORT void set_video_clock_slaving(int32_t enabled);
+EXPORT int32_t get_clock_sync_stats(ClockSyncStats* out_stats);
+EXPORT int32_t get_loudness(LoudnessStats* out_stats);
+EXPORT int32_t reset_loudness();
+EXPORT int32_t get_peaks(PeakStats* out_stats);
+EXPORT int32_t reset_peaks();
 
 #endif // BAREMETAL_DSP_ENGINE_H
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "engine_registry.h"
+#include "engine.h"
+
+EngineRegistry::EngineRegistry() {
+    for (Slot& s : slots) {
+        s.state.store(0, std::memory_order_relaxed);
+        s.engine.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+EngineRegistry& EngineRegistry::instance() {
+    static EngineRegistry registry;
+    return registry;
+}
+
+EngineRegistry::Slot* EngineRegistry::lookup(int32_t handle) {
+    if (handle <= 0) return nullptr;
+    return &slots[handle & (MAX_ENGINES - 1)];
+}
+
+int32_t EngineRegistry::create() {
+    std::lock_guard<std::mutex> lock(createMutex);
+    for (int32_t i = 0; i < MAX_ENGINES; ++i) {
+        Slot& slot = slots[i];
+        if (slot.engine.load(std::memory_order_acquire)) continue;
+
+        uint64_t generation = ((slot.state.load(std::memory_order_relaxed) >> 32) + 1) & GEN_MASK;
+        if (generation == 0) generation = 1;
+        slot.engine.store(new DSPEngine(), std::memory_order_relaxed);
+        slot.state.store((generation << 32) | OWNER_UNIT, std::memory_order_release);
+        return (int32_t)((generation << SLOT_BITS) | (uint64_t)i);
+    }
+    return -1;
+}
+
+bool EngineRegistry::add(int32_t handle, uint64_t unit, uint64_t mask, uint64_t limit) {
+    Slot* slot = lookup(handle);
+    if (!slot) return false;
+    uint64_t generation = (uint64_t)handle >> SLOT_BITS;
+    uint64_t s = slot->state.load(std::memory_order_acquire);
+    do {
+        // A handle is live only while it has an owner; calls cannot resurrect it
+        if ((s >> 32) != generation || (s & OWNER_MASK) == 0 || (s & mask) == limit) return false;
+    } while (!slot->state.compare_exchange_weak(s, s + unit, std::memory_order_acq_rel));
+    return true;
+}
+
+void EngineRegistry::drop(int32_t handle, uint64_t unit, uint64_t mask) {
+    Slot* slot = lookup(handle);
+    if (!slot) return;
+    uint64_t generation = (uint64_t)handle >> SLOT_BITS;
+    uint64_t s = slot->state.load(std::memory_order_acquire);
+    do {
+        if ((s >> 32) != generation || (s & mask) == 0) return;
+    } while (!slot->state.compare_exchange_weak(s, s - unit, std::memory_order_acq_rel));
+
+    if (((s - unit) & (OWNER_MASK | CALL_MASK)) == 0) {
+        // Last reference: nobody else can reach the engine any more
+        delete slot->engine.load(std::memory_order_relaxed);
+        slot->engine.store(nullptr, std::memory_order_release);
+    }
+}
+
+bool EngineRegistry::retain(int32_t handle) { return add(handle, OWNER_UNIT, OWNER_MASK, OWNER_MASK); }
+void EngineRegistry::destroy(int32_t handle) { drop(handle, OWNER_UNIT, OWNER_MASK); }
+
+DSPEngine* EngineRegistry::acquire(int32_t handle) {
+    return add(handle, CALL_UNIT, CALL_MASK, CALL_MASK) ? slots[handle & (MAX_ENGINES - 1)].engine.load(std::memory_order_acquire) : nullptr;
+}
+
+void EngineRegistry::release(int32_t handle) { drop(handle, CALL_UNIT, CALL_MASK); }
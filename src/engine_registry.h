@@ -0,0 +1,65 @@
+#ifndef BAREMETAL_DSP_ENGINE_REGISTRY_H
+#define BAREMETAL_DSP_ENGINE_REGISTRY_H
+
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+#define MAX_ENGINES 16
+
+class DSPEngine;
+
+// Fixed pool of engines addressed by handles that pack a slot index and a
+// generation, so a stale handle is rejected instead of touching a freed or
+// reused engine. Each slot keeps owner references (create/retain/destroy)
+// and in-flight call references in one atomic word: an engine is deleted only
+// when the last owner is gone and no call is still inside it.
+class EngineRegistry {
+public:
+    static EngineRegistry& instance();
+
+    int32_t create();               // New engine with one owner, -1 when the pool is full
+    bool retain(int32_t handle);    // Adds an owner; false for stale handles
+    void destroy(int32_t handle);   // Drops an owner
+    DSPEngine* acquire(int32_t handle); // Call reference; null for stale handles
+    void release(int32_t handle);
+
+private:
+    static constexpr int SLOT_BITS = 4; // MAX_ENGINES == 1 << SLOT_BITS
+    static constexpr uint64_t CALL_UNIT = 1;
+    static constexpr uint64_t CALL_MASK = 0xFFFF;
+    static constexpr uint64_t OWNER_UNIT = 1ull << 16;
+    static constexpr uint64_t OWNER_MASK = 0xFFFFull << 16;
+    static constexpr uint64_t GEN_MASK = 0x7FFFFF; // Keeps handles positive
+
+    struct Slot {
+        std::atomic<uint64_t> state; // generation << 32 | owners << 16 | calls
+        std::atomic<DSPEngine*> engine;
+    };
+
+    Slot slots[MAX_ENGINES];
+    std::mutex createMutex;
+
+    EngineRegistry();
+    Slot* lookup(int32_t handle);
+    bool add(int32_t handle, uint64_t unit, uint64_t mask, uint64_t limit);
+    void drop(int32_t handle, uint64_t unit, uint64_t mask);
+};
+
+// Scoped call reference: the engine stays alive until it goes out of scope.
+class EngineRef {
+public:
+    explicit EngineRef(int32_t h) : handle(h), engine(EngineRegistry::instance().acquire(h)) {}
+    ~EngineRef() { if (engine) EngineRegistry::instance().release(handle); }
+    EngineRef(const EngineRef&) = delete;
+    EngineRef& operator=(const EngineRef&) = delete;
+
+    explicit operator bool() const { return engine != nullptr; }
+    DSPEngine* operator->() const { return engine; }
+
+private:
+    int32_t handle;
+    DSPEngine* engine;
+};
+
+#endif // BAREMETAL_DSP_ENGINE_REGISTRY_H
@@ -0,0 +1,48 @@
+#include "fft.h"
+#include <cmath>
+
+FftPlan::FftPlan(int32_t size) : n(size), twiddles(size / 2) {
+    const double pi = 3.14159265358979323846;
+    for (int32_t k = 0; k < n / 2; ++k) {
+        double angle = -2.0 * pi * k / n;
+        twiddles[k] = std::complex<float>((float)std::cos(angle), (float)std::sin(angle));
+    }
+    for (int32_t i = 1, j = 0; i < n; ++i) {
+        int32_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) swaps.emplace_back(i, j);
+    }
+}
+
+void FftPlan::forward(std::complex<float>* data) const {
+    for (const auto& s : swaps) std::swap(data[s.first], data[s.second]);
+    for (int32_t len = 2; len <= n; len <<= 1) {
+        const int32_t half = len / 2, stride = n / len;
+        for (int32_t i = 0; i < n; i += len) {
+            std::complex<float>* a = data + i;
+            std::complex<float>* b = data + i + half;
+            for (int32_t j = 0; j < half; ++j) {
+                const std::complex<float> w = twiddles[j * stride];
+                // Explicit complex multiply: std::complex operator* checks for NaN/inf
+                const float re = b[j].real() * w.real() - b[j].imag() * w.imag();
+                const float im = b[j].real() * w.imag() + b[j].imag() * w.real();
+                const std::complex<float> u = a[j], v(re, im);
+                a[j] = u + v;
+                b[j] = u - v;
+            }
+        }
+    }
+}
+
+void FftPlan::forward(const float* input, const float* window, std::complex<float>* data) const {
+    for (int32_t i = 0; i < n; ++i) data[i] = std::complex<float>(input[i] * window[i], 0.0f);
+    forward(data);
+}
+
+std::vector<float> hannWindow(int32_t size) {
+    const double pi = 3.14159265358979323846;
+    std::vector<float> w(size);
+    for (int32_t i = 0; i < size; ++i) w[i] = (float)(0.5 * (1.0 - std::cos(2.0 * pi * i / (size - 1))));
+    return w;
+}
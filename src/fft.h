@@ -0,0 +1,29 @@
+#ifndef BAREMETAL_DSP_FFT_H
+#define BAREMETAL_DSP_FFT_H
+
+#include <complex>
+#include <vector>
+#include <cstdint>
+
+// Radix-2 FFT of one fixed power-of-two size. Twiddles and the bit-reversal
+// permutation are computed once, so a transform is only the butterflies.
+// Immutable after construction: one plan can serve several threads.
+class FftPlan {
+public:
+    explicit FftPlan(int32_t size);
+
+    int32_t size() const { return n; }
+    void forward(std::complex<float>* data) const; // In place
+    // Windowed real input: data[i] = input[i] * window[i], then forward
+    void forward(const float* input, const float* window, std::complex<float>* data) const;
+
+private:
+    int32_t n;
+    std::vector<std::pair<int32_t, int32_t>> swaps; // Bit-reversal pairs, i < j
+    std::vector<std::complex<float>> twiddles;      // exp(-2*pi*i*k/n), k < n/2
+};
+
+// Symmetric Hann window (denominator size - 1)
+std::vector<float> hannWindow(int32_t size);
+
+#endif // BAREMETAL_DSP_FFT_H
@@ -0,0 +1,202 @@
+#include "loudness.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// BS.1770 K-weighting at 48 kHz
+static const double SHELF_B[3] = { 1.53512485958697, -2.69169618940638, 1.19839281085285 };
+static const double SHELF_A[3] = { 1.0, -1.69065929318241, 0.73248077421585 };
+static const double HIGHPASS_B[3] = { 1.0, -2.0, 1.0 };
+static const double HIGHPASS_A[3] = { 1.0, -1.99004745483398, 0.99007225036621 };
+
+static double to_lufs(double energy) {
+    return energy > 0.0 ? -0.691 + 10.0 * std::log10(energy) : -std::numeric_limits<double>::infinity();
+}
+
+// --- Block Biquad ---
+BlockBiquad::BlockBiquad(const double b[3], const double a[3]) :
+    b0((float)b[0]), b1((float)b[1]), b2((float)b[2]), a1((float)a[1]), a2((float)a[2])
+{
+    // Column t: the four outputs when only term t is 1
+    for (int t = 0; t < 8; ++t) {
+        double x[6] = {}; // x[n-2], x[n-1], x[n..n+3]
+        double y[6] = {}; // y[n-2], y[n-1], y[n..n+3]
+        if (t < 4) x[2 + t] = 1.0;
+        else if (t == 4) x[1] = 1.0;
+        else if (t == 5) x[0] = 1.0;
+        else if (t == 6) y[1] = 1.0;
+        else y[0] = 1.0;
+        for (int k = 2; k < 6; ++k) {
+            y[k] = b[0] * x[k] + b[1] * x[k - 1] + b[2] * x[k - 2] - a[1] * y[k - 1] - a[2] * y[k - 2];
+            columns[t][k - 2] = (float)y[k];
+        }
+    }
+    reset();
+}
+
+void BlockBiquad::reset() { x1 = x2 = y1 = y2 = 0.0f; }
+
+void BlockBiquad::process(const float* in, float* out, uint32_t n) {
+    using namespace simd;
+    const f32x4 c0 = load(columns[0]), c1 = load(columns[1]), c2 = load(columns[2]), c3 = load(columns[3]);
+    const f32x4 cx1 = load(columns[4]), cx2 = load(columns[5]), cy1 = load(columns[6]), cy2 = load(columns[7]);
+    uint32_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float xa = in[i], xb = in[i + 1], xc = in[i + 2], xd = in[i + 3];
+        // Input terms first; only the last two madds wait on the previous vector
+        f32x4 v = madd(set1(x2), cx2, mul(set1(x1), cx1));
+        v = madd(set1(xa), c0, v);
+        v = madd(set1(xb), c1, v);
+        v = madd(set1(xc), c2, v);
+        v = madd(set1(xd), c3, v);
+        v = madd(set1(y2), cy2, madd(set1(y1), cy1, v));
+        store(out + i, v);
+        x2 = xc; x1 = xd;
+        y2 = lane2(v); y1 = lane3(v);
+    }
+    for (; i < n; ++i) {
+        float x = in[i];
+        float y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+        out[i] = y;
+        x2 = x1; x1 = x;
+        y2 = y1; y1 = y;
+    }
+}
+
+// --- Loudness Meter ---
+LoudnessMeter::LoudnessMeter() : shelf(SHELF_B, SHELF_A), highpass(HIGHPASS_B, HIGHPASS_A) {
+    reset();
+}
+
+void LoudnessMeter::reset() {
+    shelf.reset();
+    highpass.reset();
+    blockSum = 0.0;
+    blockFill = 0;
+    std::fill_n(subblocks, SHORT_TERM_BLOCKS, 0.0);
+    subblockCount = 0;
+    momentaryEnergy = shortTermEnergy = 0.0;
+    maxMomentary = maxShortTerm = -std::numeric_limits<double>::infinity();
+    gatedSum = rangeSum = 0.0;
+    gatedCount = rangeCount = 0;
+    std::fill_n(momentaryHistogram, HISTOGRAM_BINS, 0u);
+    std::fill_n(momentaryBinEnergy, HISTOGRAM_BINS, 0.0);
+    std::fill_n(shortTermHistogram, HISTOGRAM_BINS, 0u);
+}
+
+bool LoudnessMeter::process(const float* in, uint32_t n) {
+    using namespace simd;
+    const uint32_t CHUNK = 256;
+    float weighted[CHUNK];
+    bool completed = false;
+
+    for (uint32_t start = 0; start < n; start += CHUNK) {
+        uint32_t m = std::min(n - start, CHUNK);
+        shelf.process(in + start, weighted, m);
+        highpass.process(weighted, weighted, m);
+
+        for (uint32_t j = 0; j < m;) {
+            uint32_t take = std::min(m - j, SUBBLOCK_FRAMES - blockFill);
+            const float* w = weighted + j;
+            f32x4 acc = set1(0.0f);
+            uint32_t k = 0;
+            for (; k + 4 <= take; k += 4) { f32x4 v = load(w + k); acc = madd(v, v, acc); }
+            float sum = hsum(acc);
+            for (; k < take; ++k) sum += w[k] * w[k];
+            blockSum += sum;
+            blockFill += take;
+            j += take;
+            if (blockFill == SUBBLOCK_FRAMES) {
+                finishSubblock();
+                completed = true;
+            }
+        }
+    }
+    return completed;
+}
+
+double LoudnessMeter::windowEnergy(int32_t blocks) const {
+    double sum = 0.0;
+    for (int32_t i = 1; i <= blocks; ++i) sum += subblocks[(subblockCount - i) % SHORT_TERM_BLOCKS];
+    return sum / blocks;
+}
+
+static int32_t histogram_bin(double lufs) {
+    int32_t bin = (int32_t)std::floor((lufs - LoudnessMeter::ABSOLUTE_GATE) / LoudnessMeter::HISTOGRAM_STEP);
+    return std::min(std::max(bin, 0), LoudnessMeter::HISTOGRAM_BINS - 1);
+}
+
+void LoudnessMeter::finishSubblock() {
+    subblocks[subblockCount % SHORT_TERM_BLOCKS] = blockSum / SUBBLOCK_FRAMES;
+    ++subblockCount;
+    blockSum = 0.0;
+    blockFill = 0;
+
+    // Gating blocks overlap by 75%: one new 400 ms block per sub-block
+    if (subblockCount >= (uint64_t)MOMENTARY_BLOCKS) {
+        momentaryEnergy = windowEnergy(MOMENTARY_BLOCKS);
+        double lufs = to_lufs(momentaryEnergy);
+        maxMomentary = std::max(maxMomentary, lufs);
+        if (lufs > ABSOLUTE_GATE) {
+            gatedSum += momentaryEnergy;
+            ++gatedCount;
+            int32_t bin = histogram_bin(lufs);
+            ++momentaryHistogram[bin];
+            momentaryBinEnergy[bin] += momentaryEnergy;
+        }
+    }
+    if (subblockCount >= (uint64_t)SHORT_TERM_BLOCKS) {
+        shortTermEnergy = windowEnergy(SHORT_TERM_BLOCKS);
+        double lufs = to_lufs(shortTermEnergy);
+        maxShortTerm = std::max(maxShortTerm, lufs);
+        if (lufs > ABSOLUTE_GATE) {
+            rangeSum += shortTermEnergy;
+            ++rangeCount;
+            ++shortTermHistogram[histogram_bin(lufs)];
+        }
+    }
+}
+
+double LoudnessMeter::integrated() const {
+    if (gatedCount == 0) return -std::numeric_limits<double>::infinity();
+    int32_t first = histogram_bin(to_lufs(gatedSum / gatedCount) + RELATIVE_GATE + 0.5 * HISTOGRAM_STEP);
+    double energy = 0.0;
+    uint64_t count = 0;
+    for (int32_t i = first; i < HISTOGRAM_BINS; ++i) {
+        energy += momentaryBinEnergy[i];
+        count += momentaryHistogram[i];
+    }
+    return count ? to_lufs(energy / count) : -std::numeric_limits<double>::infinity();
+}
+
+double LoudnessMeter::range() const {
+    if (rangeCount == 0) return 0.0;
+    int32_t first = histogram_bin(to_lufs(rangeSum / rangeCount) + RANGE_GATE + 0.5 * HISTOGRAM_STEP);
+    uint64_t total = 0;
+    for (int32_t i = first; i < HISTOGRAM_BINS; ++i) total += shortTermHistogram[i];
+    if (total == 0) return 0.0;
+
+    // Nearest-rank 10th and 95th percentiles
+    const uint64_t lowRank = (uint64_t)((total - 1) * 0.10 + 0.5);
+    const uint64_t highRank = (uint64_t)((total - 1) * 0.95 + 0.5);
+    int32_t low = -1, high = -1;
+    uint64_t seen = 0;
+    for (int32_t i = first; i < HISTOGRAM_BINS && high < 0; ++i) {
+        seen += shortTermHistogram[i];
+        if (low < 0 && seen > lowRank) low = i;
+        if (seen > highRank) high = i;
+    }
+    return (high - low) * HISTOGRAM_STEP;
+}
+
+void LoudnessMeter::stats(LoudnessStats* out) const {
+    const double silent = -std::numeric_limits<double>::infinity();
+    out->momentary = subblockCount >= (uint64_t)MOMENTARY_BLOCKS ? to_lufs(momentaryEnergy) : silent;
+    out->shortTerm = subblockCount >= (uint64_t)SHORT_TERM_BLOCKS ? to_lufs(shortTermEnergy) : silent;
+    out->integrated = integrated();
+    out->range = range();
+    out->maxMomentary = maxMomentary;
+    out->maxShortTerm = maxShortTerm;
+    out->duration = (double)(subblockCount * SUBBLOCK_FRAMES + blockFill) / (SUBBLOCK_FRAMES * 10);
+}
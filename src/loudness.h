@@ -0,0 +1,90 @@
+#ifndef BAREMETAL_DSP_LOUDNESS_H
+#define BAREMETAL_DSP_LOUDNESS_H
+
+#include <cstdint>
+
+// FFI view of the loudness meter (layout mirrored in lib/ffi_bridge.dart).
+// Loudness in LUFS, range in LU; -infinity until a window has filled or
+// while everything so far is below the absolute gate.
+struct LoudnessStats {
+    double momentary;     // 400 ms window
+    double shortTerm;     // 3 s window
+    double integrated;    // Gated, since the last reset
+    double range;         // LRA (EBU Tech 3342)
+    double maxMomentary;
+    double maxShortTerm;
+    double duration;      // Seconds measured since the last reset
+};
+
+// Direct form I biquad run four samples per step: each output vector is a
+// fixed linear map of the four inputs and the two previous inputs and
+// outputs, so the recursion only serializes once per vector. The map's
+// columns are the filter's responses to each term, precomputed in double.
+class BlockBiquad {
+public:
+    BlockBiquad(const double b[3], const double a[3]); // a[0] == 1
+
+    void reset();
+    void process(const float* in, float* out, uint32_t n); // in == out allowed
+
+private:
+    float columns[8][4]; // x[n..n+3], x[n-1], x[n-2], y[n-1], y[n-2]
+    float b0, b1, b2, a1, a2;
+    float x1, x2, y1, y2;
+};
+
+// ITU-R BS.1770-4 / EBU R128 meter for the engine's mono 48 kHz signal.
+// K-weighted power accumulates per 100 ms sub-block; momentary and short
+// term are sums over the last 4 / 30 sub-blocks. Gating uses 0.1 LU
+// histograms instead of stored blocks, so memory is constant however long
+// the program runs. Single-threaded: the audio thread owns it.
+class LoudnessMeter {
+public:
+    static constexpr uint32_t SUBBLOCK_FRAMES = 4800;   // 100 ms at 48 kHz
+    static constexpr int32_t MOMENTARY_BLOCKS = 4;
+    static constexpr int32_t SHORT_TERM_BLOCKS = 30;
+    static constexpr double ABSOLUTE_GATE = -70.0;      // LUFS
+    static constexpr double RELATIVE_GATE = -10.0;      // LU, integrated
+    static constexpr double RANGE_GATE = -20.0;         // LU, loudness range
+    static constexpr double HISTOGRAM_MAX = 10.0;       // LUFS
+    static constexpr double HISTOGRAM_STEP = 0.1;       // LU
+    static constexpr int32_t HISTOGRAM_BINS = 800;      // ABSOLUTE_GATE..HISTOGRAM_MAX
+
+    LoudnessMeter();
+
+    void reset();
+    // Returns true when at least one sub-block completed (new stats).
+    bool process(const float* in, uint32_t n);
+    void stats(LoudnessStats* out) const;
+
+private:
+    BlockBiquad shelf;    // Stage 1: head-related high shelf
+    BlockBiquad highpass; // Stage 2: RLB high-pass
+
+    double blockSum;
+    uint32_t blockFill;
+    double subblocks[SHORT_TERM_BLOCKS]; // Mean square per sub-block, ring
+    uint64_t subblockCount;
+
+    double momentaryEnergy;
+    double shortTermEnergy;
+    double maxMomentary;
+    double maxShortTerm;
+
+    // Gating: exact running sums above the absolute gate plus histograms
+    // for the relative gate and the range percentiles
+    double gatedSum;
+    uint64_t gatedCount;
+    uint32_t momentaryHistogram[HISTOGRAM_BINS];
+    double momentaryBinEnergy[HISTOGRAM_BINS]; // Exact energy per bin: no bin-center bias
+    double rangeSum;
+    uint64_t rangeCount;
+    uint32_t shortTermHistogram[HISTOGRAM_BINS];
+
+    void finishSubblock();
+    double windowEnergy(int32_t blocks) const;
+    double integrated() const;
+    double range() const;
+};
+
+#endif // BAREMETAL_DSP_LOUDNESS_H
@@ -0,0 +1,86 @@
+#include "mapped_file.h"
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+    #include <vector>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#if defined(_WIN32)
+
+bool MappedFile::open(const char* path) {
+    close();
+    int wideLength = MultiByteToWideChar(CP_UTF8, 0, path, -1, nullptr, 0);
+    if (wideLength <= 0) return false;
+    std::vector<wchar_t> widePath(wideLength);
+    MultiByteToWideChar(CP_UTF8, 0, path, -1, widePath.data(), wideLength);
+
+    HANDLE file = CreateFileW(widePath.data(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) { CloseHandle(file); return false; }
+    fileHandle = file;
+    if (fileSize.QuadPart == 0) return true; // Empty files cannot be mapped
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) { close(); return false; }
+    mappingHandle = mapping;
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) { close(); return false; }
+    bytes = static_cast<const char*>(view);
+    length = (size_t)fileSize.QuadPart;
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes) UnmapViewOfFile(bytes);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    bytes = nullptr; length = 0;
+    mappingHandle = nullptr; fileHandle = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const char* path) {
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) { ::close(fd); return false; }
+    if (st.st_size == 0) { ::close(fd); return true; } // Empty files cannot be mapped
+
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps its own reference
+    if (view == MAP_FAILED) return false;
+    madvise(view, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+    bytes = static_cast<const char*>(view);
+    length = (size_t)st.st_size;
+    return true;
+}
+
+void MappedFile::close() {
+    if (bytes) munmap(const_cast<char*>(bytes), length);
+    bytes = nullptr; length = 0;
+}
+
+#endif
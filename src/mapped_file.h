@@ -0,0 +1,29 @@
+#ifndef BAREMETAL_DSP_MAPPED_FILE_H
+#define BAREMETAL_DSP_MAPPED_FILE_H
+
+#include <cstddef>
+
+// Read-only memory mapping of a whole file. Paths are UTF-8 on every platform.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const char* path);
+    void close();
+
+    const char* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const char* bytes = nullptr;
+    size_t length = 0;
+#if defined(_WIN32)
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+#endif // BAREMETAL_DSP_MAPPED_FILE_H
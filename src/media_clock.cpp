@@ -0,0 +1,63 @@
+#include "media_clock.h"
+#include <algorithm>
+#include <chrono>
+
+MediaClock::MediaClock(uint32_t rate) : sampleRate(rate), generation(0), latencySeconds(0.0) {
+    reset();
+}
+
+void MediaClock::reset() {
+    for (Anchor& a : anchors) {
+        a.position.store(0.0, std::memory_order_relaxed);
+        a.rate.store(1.0, std::memory_order_relaxed);
+        a.frameCount.store(0, std::memory_order_relaxed);
+        a.hostTime.store(0, std::memory_order_relaxed);
+    }
+    generation.store(0, std::memory_order_release);
+}
+
+int64_t MediaClock::hostNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void MediaClock::onCallback(double position, uint32_t frameCount, double rate, int64_t hostTime) {
+    uint64_t next = generation.load(std::memory_order_relaxed) + 1;
+    Anchor& a = anchors[next % SLOTS];
+    a.position.store(position, std::memory_order_relaxed);
+    a.rate.store(rate, std::memory_order_relaxed);
+    a.frameCount.store(frameCount, std::memory_order_relaxed);
+    a.hostTime.store(hostTime, std::memory_order_relaxed);
+    generation.store(next, std::memory_order_release);
+}
+
+double MediaClock::coarseNow() const {
+    uint64_t g = generation.load(std::memory_order_acquire);
+    const Anchor& a = anchors[g % SLOTS];
+    return (a.position.load(std::memory_order_relaxed) +
+            a.frameCount.load(std::memory_order_relaxed) * a.rate.load(std::memory_order_relaxed)) / sampleRate;
+}
+
+double MediaClock::now() const {
+    for (int attempt = 0; attempt < READ_ATTEMPTS; ++attempt) {
+        uint64_t g = generation.load(std::memory_order_acquire);
+        if (g == 0) return 0.0;
+
+        const Anchor& a = anchors[g % SLOTS];
+        double position = a.position.load(std::memory_order_relaxed);
+        double rate = a.rate.load(std::memory_order_relaxed);
+        uint32_t frameCount = a.frameCount.load(std::memory_order_relaxed);
+        int64_t hostTime = a.hostTime.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (generation.load(std::memory_order_relaxed) - g >= SLOTS - 1) continue; // Lapped: slot may be torn
+
+        // Never run past the block the device was given: a late callback holds
+        // the clock instead of letting it overshoot and jump back
+        double elapsedFrames = (double)(hostNanos() - hostTime) * 1e-9 * sampleRate;
+        elapsedFrames = std::min(std::max(elapsedFrames, 0.0), (double)frameCount);
+        double t = (position + elapsedFrames * rate) / sampleRate - latency();
+        return std::max(t, 0.0);
+    }
+    // Still lapped: the coarse count, compensated like the interpolated path
+    return std::max(coarseNow() - latency(), 0.0);
+}
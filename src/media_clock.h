@@ -0,0 +1,52 @@
+#ifndef BAREMETAL_DSP_MEDIA_CLOCK_H
+#define BAREMETAL_DSP_MEDIA_CLOCK_H
+
+#include <atomic>
+#include <cstdint>
+
+// High-resolution media clock. The audio thread stamps every callback with
+// the content position, the playback rate and a monotonic host time; readers interpolate between
+// callbacks and subtract the output latency, so the clock tracks what is
+// audible now instead of what was last handed to the device.
+//
+// Anchors go to a small ring of slots; a reader copies the newest slot and
+// retries if the writer lapped the whole ring meanwhile. After READ_ATTEMPTS
+// laps it falls back to the latency-compensated coarse frame count, so reads
+// stay wait-free.
+class MediaClock {
+public:
+    explicit MediaClock(uint32_t sampleRate);
+
+    void reset(); // Call while no callback can run
+
+    // Audio thread, once per callback: `position` is the content frame at the
+    // block's first output frame and `rate` the content frames consumed per
+    // output frame (1 unless the playback is being resampled). `hostTime`
+    // (hostNanos) is when the callback began; re-anchoring mid-block reuses it.
+    void onCallback(double position, uint32_t frameCount, double rate, int64_t hostTime);
+
+    void setLatency(double seconds) { latencySeconds.store(seconds, std::memory_order_relaxed); }
+    double latency() const { return latencySeconds.load(std::memory_order_relaxed); }
+
+    double now() const;           // Interpolated, latency compensated
+    double coarseNow() const;     // Frame count only, advances per callback
+    static int64_t hostNanos();   // Monotonic host time used for the anchors
+
+private:
+    static constexpr uint32_t SLOTS = 4;
+    static constexpr int READ_ATTEMPTS = 4;
+
+    struct Anchor {
+        std::atomic<double> position;
+        std::atomic<double> rate;
+        std::atomic<uint32_t> frameCount;
+        std::atomic<int64_t> hostTime;
+    };
+
+    const uint32_t sampleRate;
+    Anchor anchors[SLOTS];
+    std::atomic<uint64_t> generation;
+    std::atomic<double> latencySeconds;
+};
+
+#endif // BAREMETAL_DSP_MEDIA_CLOCK_H
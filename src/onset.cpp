@@ -0,0 +1,83 @@
+#include "onset.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+
+OnsetDetector::OnsetDetector(int32_t bins, int32_t hopSize, float sampleRate)
+    : bins(bins), blocks(hopSize / REFINE_BLOCK), sampleRate(sampleRate),
+      minIntervalHops(std::max(1, (int32_t)std::ceil(MIN_INTERVAL * sampleRate / hopSize))),
+      previous(bins, 0.0f) {
+    reset();
+}
+
+void OnsetDetector::reset() {
+    std::fill(previous.begin(), previous.end(), 0.0f);
+    lastBlockEnergy = 0.0f;
+    std::fill(window, window + MEDIAN_HOPS, 0.0f);
+    windowFill = 0;
+    windowHead = 0;
+    before = candidate = current = { 0.0f, 0.0 };
+    hopsSinceOnset = minIntervalHops;
+}
+
+bool OnsetDetector::process(const float* magnitudes, const float* samples, double position, double rate, OnsetEvent* out) {
+    using namespace simd;
+    const float ln2 = 0.693147181f;
+    const f32x4 gain = set1(COMPRESSION), one = set1(1.0f), zero = set1(0.0f);
+
+    // 1. Detection function: rectified rise of the compressed magnitudes
+    f32x4 rise = zero;
+    float* prev = previous.data();
+    int32_t i = 0;
+    for (; i + 4 <= bins; i += 4) {
+        f32x4 c = log2Approx(madd(load(magnitudes + i), gain, one));
+        rise = add(rise, max(sub(c, load(prev + i)), zero));
+        store(prev + i, c);
+    }
+    float tail = 0.0f;
+    for (; i < bins; ++i) {
+        float c = std::log2(1.0f + COMPRESSION * magnitudes[i]);
+        tail += std::max(c - prev[i], 0.0f);
+        prev[i] = c;
+    }
+    const float value = (hsum(rise) + tail) * ln2 / bins;
+
+    // 2. Where in this hop the energy rises most sharply
+    int32_t sharpest = 0;
+    float bestRise = 0.0f;
+    float last = lastBlockEnergy;
+    for (int32_t b = 0; b < blocks; ++b) {
+        const float* s = samples + b * REFINE_BLOCK;
+        f32x4 acc = zero;
+        for (int32_t k = 0; k + 4 <= REFINE_BLOCK; k += 4) acc = madd(load(s + k), load(s + k), acc);
+        float e = hsum(acc);
+        if (e - last > bestRise) { bestRise = e - last; sharpest = b; }
+        last = e;
+    }
+    lastBlockEnergy = last;
+
+    before = candidate;
+    candidate = current;
+    current = { value, position + sharpest * REFINE_BLOCK * rate };
+    ++hopsSinceOnset;
+
+    window[windowHead] = value;
+    windowHead = (windowHead + 1) % MEDIAN_HOPS;
+    windowFill = std::min(windowFill + 1, MEDIAN_HOPS);
+
+    // 3. Peak picking on the previous hop, now that its successor is known
+    if (candidate.value <= before.value || candidate.value < current.value) return false;
+    if (hopsSinceOnset <= minIntervalHops) return false;
+    float sorted[MEDIAN_HOPS];
+    std::copy_n(window, windowFill, sorted);
+    std::nth_element(sorted, sorted + windowFill / 2, sorted + windowFill);
+    const float threshold = DELTA + LAMBDA * sorted[windowFill / 2];
+    if (candidate.value <= threshold) return false;
+
+    hopsSinceOnset = 1; // The candidate is one hop old
+    out->frame = (uint64_t)std::max(0.0, candidate.onset);
+    out->time = candidate.onset / sampleRate;
+    out->strength = candidate.value;
+    out->threshold = threshold;
+    return true;
+}
@@ -0,0 +1,67 @@
+#ifndef BAREMETAL_DSP_ONSET_H
+#define BAREMETAL_DSP_ONSET_H
+
+#include <vector>
+#include <cstdint>
+
+// FFI view of one detected onset (layout mirrored in lib/ffi_bridge.dart)
+struct OnsetEvent {
+    uint64_t frame;  // Content frame (source sample index) of the onset
+    double time;     // Same in seconds, comparable with the media clock
+    float strength;  // Onset-detection value at the peak
+    float threshold; // Adaptive threshold it crossed
+};
+
+// Spectral-flux onset detector run once per analysis hop. The detection
+// function is the rectified rise of log-compressed magnitudes, log(1 + g*m),
+// averaged over the bins. A hop is an onset when its value is a local
+// maximum above delta + lambda * median of the surrounding MEDIAN_HOPS, at
+// least MIN_INTERVAL after the previous onset; the local-maximum test costs
+// one hop of latency. The onset is placed inside its hop at the sharpest
+// rise of short-block energy, so its position is good to REFINE_BLOCK
+// samples rather than to a whole hop. Single-threaded: the audio thread
+// owns it.
+class OnsetDetector {
+public:
+    static constexpr float COMPRESSION = 100.0f; // g
+    static constexpr float DELTA = 0.01f;
+    static constexpr float LAMBDA = 1.5f;
+    static constexpr int32_t MEDIAN_HOPS = 11;
+    static constexpr float MIN_INTERVAL = 0.05f; // Seconds
+    static constexpr int32_t REFINE_BLOCK = 64;  // Samples
+
+    OnsetDetector(int32_t bins, int32_t hopSize, float sampleRate);
+
+    void reset();
+    // `samples` is the hop's time-domain frame (hopSize samples) starting at
+    // content frame `position`, with `rate` content frames per sample (1
+    // unless playback is resampled). Returns true and fills `out` when the
+    // previous hop turned out to be an onset.
+    bool process(const float* magnitudes, const float* samples, double position, double rate, OnsetEvent* out);
+    // Detection function of the latest hop and where in it the energy rose
+    // most sharply (content frame), for tempo tracking
+    float novelty() const { return current.value; }
+    double noveltyPosition() const { return current.onset; }
+
+private:
+    struct Hop {
+        float value;    // Detection function
+        double onset;   // Content frame of the sharpest energy rise
+    };
+
+    int32_t bins;
+    int32_t blocks;               // REFINE_BLOCKs per hop
+    float sampleRate;
+    int32_t minIntervalHops;
+    std::vector<float> previous;  // Last hop's compressed magnitudes
+    float lastBlockEnergy;        // Final block of the previous hop
+    float window[MEDIAN_HOPS];    // Recent detection values, ring
+    int32_t windowFill;
+    int32_t windowHead;
+    Hop before;                   // Hop n-2
+    Hop candidate;                // Hop n-1
+    Hop current;                  // Hop n
+    int32_t hopsSinceOnset;
+};
+
+#endif // BAREMETAL_DSP_ONSET_H
@@ -0,0 +1,97 @@
+#include "pitch.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+PitchTracker::PitchTracker(const FftPlan& plan, float sampleRate)
+    : plan(plan), sampleRate(sampleRate), size(plan.size()),
+      minLag((int32_t)std::floor(sampleRate / MAX_HZ)),
+      maxLag((int32_t)std::ceil(sampleRate / MIN_HZ)),
+      window(plan.size() - maxLag - 1),
+      frame(plan.size(), 0.0f), packed(plan.size()), product(plan.size()),
+      energy(plan.size() + 1, 0.0), difference(maxLag + 2, 1.0f) {
+    reset();
+}
+
+void PitchTracker::reset() {
+    std::fill(frame.begin(), frame.end(), 0.0f);
+    pending = 0;
+    current = { 0.0f, 0.0f, 0.0f };
+}
+
+bool PitchTracker::process(const float* in, uint32_t n) {
+    bool updated = false;
+    while (n > 0) {
+        uint32_t chunk = std::min(n, HOP - pending);
+        memcpy(frame.data() + size - HOP + pending, in, chunk * sizeof(float));
+        pending += chunk;
+        in += chunk;
+        n -= chunk;
+        if (pending == HOP) {
+            analyze();
+            memmove(frame.data(), frame.data() + HOP, (size - HOP) * sizeof(float));
+            pending = 0;
+            updated = true;
+        }
+    }
+    return updated;
+}
+
+void PitchTracker::analyze() {
+    const float* x = frame.data();
+    for (int32_t i = 0; i < size; ++i) energy[i + 1] = energy[i] + (double)x[i] * x[i];
+    if (energy[size] < SILENCE * size) {
+        current = { 0.0f, 0.0f, 0.0f };
+        return;
+    }
+
+    // r(tau) = sum_{j < window} x[j] * x[j + tau]: cross spectrum of the
+    // windowed head and the whole frame, both unpacked from one transform
+    for (int32_t i = 0; i < size; ++i) packed[i] = { x[i], i < window ? x[i] : 0.0f };
+    plan.forward(packed.data());
+    for (int32_t k = 0; k < size; ++k) {
+        // whole = (Z[k] + conj Z[-k]) / 2, head = (Z[k] - conj Z[-k]) / 2i,
+        // stored as conj(conj(head) * whole) so the forward plan inverts it
+        const std::complex<float> z = packed[k], y = packed[(size - k) & (size - 1)];
+        const float wholeRe = 0.5f * (z.real() + y.real()), wholeIm = 0.5f * (z.imag() - y.imag());
+        const float headRe = 0.5f * (z.imag() + y.imag()), headIm = 0.5f * (y.real() - z.real());
+        product[k] = { headRe * wholeRe + headIm * wholeIm, headIm * wholeRe - headRe * wholeIm };
+    }
+    plan.forward(product.data());
+    const float scale = 1.0f / size;
+
+    // d(tau) = sum (x[j] - x[j + tau])^2 = E(0) + E(tau) - 2 r(tau), then
+    // the cumulative mean normalized difference d'(tau) = d(tau) * tau / sum d
+    const double head = energy[window];
+    double sum = 0.0;
+    difference[0] = 1.0f;
+    for (int32_t tau = 1; tau <= maxLag + 1; ++tau) {
+        double d = head + (energy[tau + window] - energy[tau]) - 2.0 * product[tau].real() * scale;
+        d = std::max(d, 0.0);
+        sum += d;
+        difference[tau] = sum > 0.0 ? (float)(d * tau / sum) : 1.0f;
+    }
+
+    // First dip under the threshold, followed to its minimum
+    int32_t best = -1;
+    for (int32_t tau = minLag; tau <= maxLag; ++tau) {
+        if (difference[tau] < THRESHOLD) {
+            while (tau < maxLag && difference[tau + 1] < difference[tau]) ++tau;
+            best = tau;
+            break;
+        }
+    }
+    if (best < 0) {
+        float lowest = *std::min_element(difference.begin() + minLag, difference.begin() + maxLag + 1);
+        current = { 0.0f, std::clamp(1.0f - lowest, 0.0f, 1.0f), 0.0f };
+        return;
+    }
+
+    float a = difference[best - 1], b = difference[best], c = difference[best + 1];
+    float denominator = a - 2.0f * b + c;
+    float offset = denominator > 0.0f ? std::clamp(0.5f * (a - c) / denominator, -0.5f, 0.5f) : 0.0f;
+    float frequency = sampleRate / (best + offset);
+    current.frequency = frequency;
+    current.confidence = std::clamp(1.0f - b, 0.0f, 1.0f);
+    current.note = 69.0f + 12.0f * std::log2(frequency / 440.0f);
+}
@@ -0,0 +1,58 @@
+#ifndef BAREMETAL_DSP_PITCH_H
+#define BAREMETAL_DSP_PITCH_H
+
+#include "fft.h"
+#include <complex>
+#include <vector>
+#include <cstdint>
+
+// FFI view of one pitch estimate (layout mirrored in lib/ffi_bridge.dart)
+struct PitchEstimate {
+    float frequency;  // Hz, 0 when unvoiced
+    float confidence; // 1 - YIN aperiodicity at the chosen lag, 0..1
+    float note;       // MIDI note (69 = A4), fraction = cents / 100; 0 when unvoiced
+};
+
+// YIN monophonic pitch over a sliding frame of one FFT plan's size, updated
+// every HOP samples. The difference function comes from one packed complex
+// FFT (the frame in the real part, its first `window` samples in the
+// imaginary part) and one inverse, so each hop costs two transforms instead
+// of the window * lags products of the time-domain version. The cumulative
+// mean normalized difference is searched for its first dip below THRESHOLD
+// and the lag refined parabolically. Single-threaded: the audio thread owns
+// it; the plan is shared and immutable, and must be longer than
+// sampleRate / MIN_HZ (1024 points at 48 kHz leave a 423-sample window).
+class PitchTracker {
+public:
+    static constexpr uint32_t HOP = 256;
+    static constexpr float MIN_HZ = 80.0f;
+    static constexpr float MAX_HZ = 2000.0f;
+    static constexpr float THRESHOLD = 0.10f;
+    static constexpr float SILENCE = 1e-8f; // Mean square, -80 dBFS
+
+    PitchTracker(const FftPlan& plan, float sampleRate);
+
+    void reset();
+    // Returns true when at least one hop completed; estimate() is the latest
+    bool process(const float* in, uint32_t n);
+    const PitchEstimate& estimate() const { return current; }
+
+private:
+    const FftPlan& plan;
+    float sampleRate;
+    int32_t size;
+    int32_t minLag;
+    int32_t maxLag;
+    int32_t window;   // size - maxLag - 1: every lag up to maxLag + 1 stays inside the frame
+    uint32_t pending; // Samples since the last hop
+    std::vector<float> frame;                // Newest `size` samples, oldest first
+    std::vector<std::complex<float>> packed;
+    std::vector<std::complex<float>> product;
+    std::vector<double> energy;              // Prefix sums of frame^2
+    std::vector<float> difference;           // Cumulative mean normalized
+    PitchEstimate current;
+
+    void analyze();
+};
+
+#endif // BAREMETAL_DSP_PITCH_H
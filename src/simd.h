@@ -0,0 +1,125 @@
+#ifndef BAREMETAL_DSP_SIMD_H
+#define BAREMETAL_DSP_SIMD_H
+
+// Minimal 4-lane float vector over SSE2 (x86/x64) and NEON (ARM), with a
+// scalar fallback. Only what the block kernels need; loads and stores are
+// unaligned.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define DSP_SIMD_SSE2 1
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define DSP_SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+namespace simd {
+
+#if defined(DSP_SIMD_SSE2)
+
+struct f32x4 { __m128 v; };
+
+inline f32x4 load(const float* p) { return { _mm_loadu_ps(p) }; }
+inline void store(float* p, f32x4 a) { _mm_storeu_ps(p, a.v); }
+inline f32x4 set1(float x) { return { _mm_set1_ps(x) }; }
+inline f32x4 setr(float a, float b, float c, float d) { return { _mm_setr_ps(a, b, c, d) }; }
+inline f32x4 add(f32x4 a, f32x4 b) { return { _mm_add_ps(a.v, b.v) }; }
+inline f32x4 sub(f32x4 a, f32x4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+inline f32x4 mul(f32x4 a, f32x4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c) { return { _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v) }; } // a*b + c
+inline f32x4 max(f32x4 a, f32x4 b) { return { _mm_max_ps(a.v, b.v) }; }
+inline f32x4 min(f32x4 a, f32x4 b) { return { _mm_min_ps(a.v, b.v) }; }
+// x = 2^exponent * mantissa, mantissa in [1, 2); x must be positive and normal
+inline void split(f32x4 x, f32x4& exponent, f32x4& mantissa) {
+    __m128i bits = _mm_castps_si128(x.v);
+    exponent.v = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+    mantissa.v = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+}
+// Lanes move up, zeros come in: {0, a0, a1, a2} and {0, 0, a0, a1}
+inline f32x4 shiftUp1(f32x4 a) { return { _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(a.v), 4)) }; }
+inline f32x4 shiftUp2(f32x4 a) { return { _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(a.v), 8)) }; }
+inline float lane2(f32x4 a) { return _mm_cvtss_f32(_mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 2, 2, 2))); }
+inline float lane3(f32x4 a) { return _mm_cvtss_f32(_mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(3, 3, 3, 3))); }
+inline float hsum(f32x4 a) {
+    __m128 s = _mm_add_ps(a.v, _mm_movehl_ps(a.v, a.v));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(s);
+}
+
+#elif defined(DSP_SIMD_NEON)
+
+struct f32x4 { float32x4_t v; };
+
+inline f32x4 load(const float* p) { return { vld1q_f32(p) }; }
+inline void store(float* p, f32x4 a) { vst1q_f32(p, a.v); }
+inline f32x4 set1(float x) { return { vdupq_n_f32(x) }; }
+inline f32x4 setr(float a, float b, float c, float d) { const float t[4] = { a, b, c, d }; return { vld1q_f32(t) }; }
+inline f32x4 add(f32x4 a, f32x4 b) { return { vaddq_f32(a.v, b.v) }; }
+inline f32x4 sub(f32x4 a, f32x4 b) { return { vsubq_f32(a.v, b.v) }; }
+inline f32x4 mul(f32x4 a, f32x4 b) { return { vmulq_f32(a.v, b.v) }; }
+inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c) { return { vmlaq_f32(c.v, a.v, b.v) }; }
+inline f32x4 max(f32x4 a, f32x4 b) { return { vmaxq_f32(a.v, b.v) }; }
+inline f32x4 min(f32x4 a, f32x4 b) { return { vminq_f32(a.v, b.v) }; }
+inline void split(f32x4 x, f32x4& exponent, f32x4& mantissa) {
+    uint32x4_t bits = vreinterpretq_u32_f32(x.v);
+    exponent.v = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127)));
+    mantissa.v = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007FFFFF)), vdupq_n_u32(0x3F800000)));
+}
+inline f32x4 shiftUp1(f32x4 a) { return { vextq_f32(vdupq_n_f32(0.0f), a.v, 3) }; }
+inline f32x4 shiftUp2(f32x4 a) { return { vextq_f32(vdupq_n_f32(0.0f), a.v, 2) }; }
+inline float lane2(f32x4 a) { return vgetq_lane_f32(a.v, 2); }
+inline float lane3(f32x4 a) { return vgetq_lane_f32(a.v, 3); }
+inline float hsum(f32x4 a) {
+    float32x2_t s = vadd_f32(vget_low_f32(a.v), vget_high_f32(a.v));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+}
+
+#else
+
+#include <cstdint>
+#include <cstring>
+
+struct f32x4 { float v[4]; };
+
+inline f32x4 load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+inline void store(float* p, f32x4 a) { for (int i = 0; i < 4; ++i) p[i] = a.v[i]; }
+inline f32x4 set1(float x) { return { { x, x, x, x } }; }
+inline f32x4 setr(float a, float b, float c, float d) { return { { a, b, c, d } }; }
+inline f32x4 add(f32x4 a, f32x4 b) { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+inline f32x4 sub(f32x4 a, f32x4 b) { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+inline f32x4 mul(f32x4 a, f32x4 b) { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+inline f32x4 madd(f32x4 a, f32x4 b, f32x4 c) { for (int i = 0; i < 4; ++i) c.v[i] += a.v[i] * b.v[i]; return c; }
+inline f32x4 max(f32x4 a, f32x4 b) { for (int i = 0; i < 4; ++i) a.v[i] = a.v[i] > b.v[i] ? a.v[i] : b.v[i]; return a; }
+inline f32x4 min(f32x4 a, f32x4 b) { for (int i = 0; i < 4; ++i) a.v[i] = a.v[i] < b.v[i] ? a.v[i] : b.v[i]; return a; }
+inline void split(f32x4 x, f32x4& exponent, f32x4& mantissa) {
+    for (int i = 0; i < 4; ++i) {
+        uint32_t bits;
+        std::memcpy(&bits, &x.v[i], sizeof(bits));
+        exponent.v[i] = (float)((int32_t)(bits >> 23) - 127);
+        bits = (bits & 0x007FFFFF) | 0x3F800000;
+        std::memcpy(&mantissa.v[i], &bits, sizeof(bits));
+    }
+}
+inline f32x4 shiftUp1(f32x4 a) { return { { 0.0f, a.v[0], a.v[1], a.v[2] } }; }
+inline f32x4 shiftUp2(f32x4 a) { return { { 0.0f, 0.0f, a.v[0], a.v[1] } }; }
+inline float lane2(f32x4 a) { return a.v[2]; }
+inline float lane3(f32x4 a) { return a.v[3]; }
+inline float hsum(f32x4 a) { return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]); }
+
+#endif
+
+// log2 for positive normal inputs: exponent plus a degree-4 least-squares
+// polynomial in the mantissa. Max error 1.2e-4 (0.0004 dB), no table.
+inline f32x4 log2Approx(f32x4 x) {
+    f32x4 exponent, mantissa;
+    split(x, exponent, mantissa);
+    f32x4 t = sub(mantissa, set1(1.0f));
+    f32x4 p = madd(t, set1(-0.0828606982f), set1(0.321879707f));
+    p = madd(t, p, set1(-0.677743267f));
+    p = madd(t, p, set1(1.43863803f));
+    return madd(t, p, exponent);
+}
+
+} // namespace simd
+
+#endif // BAREMETAL_DSP_SIMD_H
@@ -0,0 +1,93 @@
+#ifndef BAREMETAL_DSP_SNAPSHOT_H
+#define BAREMETAL_DSP_SNAPSHOT_H
+
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+// Fixed-size frame (float by default) published by one writer (the audio
+// thread, once per hop) with a sequence lock. The writer never waits; readers
+// on any thread copy out a consistent frame and retry if a publish overlapped
+// the copy.
+template <uint32_t Size, typename T = float>
+class FrameSnapshot {
+public:
+    FrameSnapshot() : sequence(0) {
+        for (auto& v : values) v.store(T(0), std::memory_order_relaxed);
+    }
+
+    void publish(const T* src) {
+        uint64_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (uint32_t i = 0; i < Size; ++i) values[i].store(src[i], std::memory_order_relaxed);
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    // Copies the latest frame, returns its number (0 before the first publish).
+    uint64_t read(T* out) const {
+        for (;;) {
+            uint64_t seq = sequence.load(std::memory_order_acquire);
+            if (seq & 1) continue;
+            for (uint32_t i = 0; i < Size; ++i) out[i] = values[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == seq) return seq / 2;
+        }
+    }
+
+    uint64_t frame() const { return sequence.load(std::memory_order_acquire) / 2; }
+
+private:
+    std::atomic<uint64_t> sequence;
+    std::atomic<T> values[Size];
+};
+
+// Ring of the most recent samples written by one thread (the audio thread)
+// and copied out by readers on any thread. Writes land in batches of at most
+// MAX_BATCH; a reader detects a copy that the writer lapped and retries.
+class SampleRing {
+public:
+    static constexpr uint32_t MAX_BATCH = 256;
+
+    explicit SampleRing(uint32_t capacity) : mask(capacity - 1), cells(new std::atomic<float>[capacity]), count(0) {
+        for (uint32_t i = 0; i < capacity; ++i) cells[i].store(0.0f, std::memory_order_relaxed);
+    }
+
+    uint32_t capacity() const { return mask + 1; }
+    uint64_t written() const { return count.load(std::memory_order_acquire); }
+
+    void write(const float* samples, uint32_t n) {
+        uint64_t pos = count.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < n;) {
+            uint32_t batch = std::min(n - i, MAX_BATCH);
+            std::atomic_thread_fence(std::memory_order_release);
+            for (uint32_t k = 0; k < batch; ++k) cells[(pos + k) & mask].store(samples[i + k], std::memory_order_relaxed);
+            pos += batch;
+            i += batch;
+            count.store(pos, std::memory_order_release);
+        }
+    }
+
+    // Copies the newest `n` samples (n <= capacity - MAX_BATCH), oldest first;
+    // zeros stand in for samples not recorded yet. Returns the end position.
+    uint64_t readLatest(float* out, uint32_t n) const {
+        for (;;) {
+            uint64_t end = count.load(std::memory_order_acquire);
+            uint32_t missing = end < n ? (uint32_t)(n - end) : 0;
+            std::fill(out, out + missing, 0.0f);
+            uint64_t start = end - (n - missing);
+            for (uint32_t i = missing; i < n; ++i) out[i] = cells[(start + i - missing) & mask].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // The writer may be one batch past what it has published
+            if (count.load(std::memory_order_relaxed) + MAX_BATCH <= start + capacity()) return end;
+        }
+    }
+
+private:
+    uint32_t mask; // capacity - 1, capacity a power of two
+    std::unique_ptr<std::atomic<float>[]> cells;
+    std::atomic<uint64_t> count;
+};
+
+#endif // BAREMETAL_DSP_SNAPSHOT_H
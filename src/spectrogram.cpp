@@ -0,0 +1,156 @@
+#include "spectrogram.h"
+#include "spectrum.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Inferno (matplotlib) at eleven evenly spaced stops
+static const uint8_t INFERNO_STOPS[11][3] = {
+    {0, 0, 4}, {22, 11, 57}, {66, 10, 104}, {106, 23, 110}, {147, 38, 103}, {188, 55, 84},
+    {221, 81, 58}, {243, 120, 25}, {252, 165, 10}, {246, 215, 70}, {252, 255, 164}
+};
+
+static uint32_t pack_rgba(const uint8_t* rgba) {
+    uint32_t pixel;
+    std::memcpy(&pixel, rgba, sizeof(pixel));
+    return pixel;
+}
+
+// --- History ---
+SpectrogramHistory::SpectrogramHistory(int32_t bins, int32_t capacity) :
+    binCount(bins), frames(capacity), words(bins / 4),
+    cells(new std::atomic<uint32_t>[(size_t)capacity * (bins / 4)]), scratch(bins), count(0)
+{
+    for (size_t i = 0; i < (size_t)frames * words; ++i) cells[i].store(0, std::memory_order_relaxed);
+}
+
+void SpectrogramHistory::push(const float* magnitudes) {
+    for (int32_t i = 0; i < binCount; ++i) scratch[i] = magnitudes[i] * magnitudes[i];
+    powerToNormalizedDb(scratch.data(), scratch.data(), binCount, FLOOR_DB, CEIL_DB);
+
+    uint64_t frame = count.load(std::memory_order_relaxed);
+    std::atomic<uint32_t>* slot = cells.get() + (frame % frames) * words;
+    // Readers that see any new byte also see `count` >= frame, so they know
+    // the slot they copied from is being recycled
+    std::atomic_thread_fence(std::memory_order_release);
+    for (int32_t w = 0; w < words; ++w) {
+        const float* q = scratch.data() + w * 4;
+        uint32_t packed = 0;
+        for (int k = 0; k < 4; ++k) packed |= (uint32_t)(q[k] * 255.0f + 0.5f) << (8 * k);
+        slot[w].store(packed, std::memory_order_relaxed);
+    }
+    count.store(frame + 1, std::memory_order_release);
+}
+
+bool SpectrogramHistory::read(uint64_t frame, uint8_t* out) const {
+    uint64_t total = count.load(std::memory_order_acquire);
+    if (frame >= total || total - frame > (uint64_t)frames) return false;
+    const std::atomic<uint32_t>* slot = cells.get() + (frame % frames) * words;
+    for (int32_t w = 0; w < words; ++w) {
+        uint32_t packed = slot[w].load(std::memory_order_relaxed);
+        for (int k = 0; k < 4; ++k) out[w * 4 + k] = (uint8_t)(packed >> (8 * k));
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return count.load(std::memory_order_relaxed) < frame + frames;
+}
+
+// --- Raster ---
+SpectrogramRaster::SpectrogramRaster() :
+    width(0), height(0), floorDb(-90.0f), ceilDb(0.0f), rendered(0), dirty(true)
+{
+    setColormap(SpectrogramColormap::INFERNO, floorDb, ceilDb);
+}
+
+bool SpectrogramRaster::configure(int32_t w, int32_t h, float minHz, float maxHz, float sampleRate, int32_t fftSize) {
+    const int32_t bins = fftSize / 2;
+    maxHz = std::min(maxHz, sampleRate / 2.0f);
+    if (w <= 0 || w > SpectrogramHistory::MAX_CAPACITY || h <= 0 || h > MAX_HEIGHT || minHz <= 0.0f || maxHz <= minHz) return false;
+
+    width = w;
+    height = h;
+    rowFirst.resize(h);
+    rowLast.resize(h);
+    const double hzPerBin = (double)sampleRate / fftSize;
+    const double ratio = std::pow((double)maxHz / minHz, 1.0 / h);
+    for (int32_t r = 0; r < h; ++r) {
+        // Row 0 is the top of the image: the highest band
+        double lo = minHz * std::pow(ratio, h - 1 - r) / hzPerBin;
+        double hi = lo * ratio;
+        int32_t first = std::min((int32_t)(lo + 0.5), bins - 1);
+        rowFirst[r] = first;
+        rowLast[r] = std::min(std::max(first, (int32_t)(hi + 0.5) - 1), bins - 1);
+    }
+    pixels.assign((size_t)w * h, lut[0]);
+    column.resize(bins);
+    dirty = true;
+    return true;
+}
+
+void SpectrogramRaster::setColormap(SpectrogramColormap colormap, float lo, float hi) {
+    uint8_t rgba[256 * 4];
+    for (int i = 0; i < 256; ++i) {
+        uint8_t* c = rgba + i * 4;
+        if (colormap == SpectrogramColormap::GRAY) {
+            c[0] = c[1] = c[2] = (uint8_t)i;
+        } else {
+            float pos = i * (10.0f / 255.0f);
+            int stop = std::min((int)pos, 9);
+            float frac = pos - stop;
+            for (int ch = 0; ch < 3; ++ch) {
+                float a = INFERNO_STOPS[stop][ch], b = INFERNO_STOPS[stop + 1][ch];
+                c[ch] = (uint8_t)(a + (b - a) * frac + 0.5f);
+            }
+        }
+        c[3] = 255;
+    }
+    setColormap(rgba, lo, hi);
+}
+
+void SpectrogramRaster::setColormap(const uint8_t* rgba, float lo, float hi) {
+    std::memcpy(palette, rgba, sizeof(palette));
+    floorDb = lo;
+    ceilDb = hi > lo ? hi : lo + 1.0f;
+    buildLut();
+    dirty = true;
+}
+
+void SpectrogramRaster::buildLut() {
+    const float step = (SpectrogramHistory::CEIL_DB - SpectrogramHistory::FLOOR_DB) / 255.0f;
+    for (int b = 0; b < 256; ++b) {
+        float db = SpectrogramHistory::FLOOR_DB + b * step;
+        float t = std::min(std::max((db - floorDb) / (ceilDb - floorDb), 0.0f), 1.0f);
+        lut[b] = pack_rgba(palette + (int)(t * 255.0f + 0.5f) * 4);
+    }
+}
+
+void SpectrogramRaster::drawColumn(int32_t x, const uint8_t* values) {
+    uint32_t* p = pixels.data() + x;
+    for (int32_t r = 0; r < height; ++r, p += width) {
+        uint8_t v = values[rowFirst[r]];
+        for (int32_t b = rowFirst[r] + 1; b <= rowLast[r]; ++b) v = std::max(v, values[b]);
+        *p = lut[v];
+    }
+}
+
+void SpectrogramRaster::update(const SpectrogramHistory& history, SpectrogramView* out) {
+    uint64_t total = history.written();
+    uint64_t visible = total > (uint64_t)width ? total - width : 0;
+    if (dirty) {
+        std::fill(pixels.begin(), pixels.end(), lut[0]);
+        rendered = visible;
+        dirty = false;
+    }
+    uint64_t from = std::max(rendered, visible);
+    for (uint64_t f = from; f < total; ++f) {
+        if (!history.read(f, column.data())) std::fill(column.begin(), column.end(), 0);
+        drawColumn((int32_t)(f % width), column.data());
+    }
+    rendered = total;
+
+    out->pixels = reinterpret_cast<const uint8_t*>(pixels.data());
+    out->width = width;
+    out->height = height;
+    out->headColumn = (int32_t)(total % width);
+    out->updatedColumns = (int32_t)(total - from);
+    out->frame = total;
+}
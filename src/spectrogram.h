@@ -0,0 +1,91 @@
+#ifndef BAREMETAL_DSP_SPECTROGRAM_H
+#define BAREMETAL_DSP_SPECTROGRAM_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+// FFI view of the waterfall texture (layout mirrored in lib/ffi_bridge.dart).
+// The image is a ring: frame f lives in column f % width, so draw
+// [headColumn, width) followed by [0, headColumn) to scroll it.
+struct SpectrogramView {
+    const uint8_t* pixels;  // RGBA8, row 0 = highest frequency
+    int32_t width;          // Columns (spectra)
+    int32_t height;         // Rows (log-spaced frequency)
+    int32_t headColumn;     // Oldest column, where the next frame will land
+    int32_t updatedColumns; // Columns redrawn by this call
+    uint64_t frame;         // Spectra recorded so far
+};
+
+enum class SpectrogramColormap : int32_t {
+    GRAY = 0,
+    INFERNO = 1
+};
+
+// Ring of the last `capacity` spectra as 8-bit log magnitudes (FLOOR_DB..CEIL_DB
+// in 256 steps), four bins per atomic word. One writer (the audio thread)
+// appends; readers on any thread copy columns and detect overwrites.
+class SpectrogramHistory {
+public:
+    static constexpr int32_t MAX_CAPACITY = 8192; // ~175 s of 1024-sample hops
+    static constexpr float FLOOR_DB = -120.0f;
+    static constexpr float CEIL_DB = 0.0f;
+
+    // bins: multiple of 4; capacity: 1..MAX_CAPACITY spectra. Allocates, so
+    // construct it off the audio thread.
+    SpectrogramHistory(int32_t bins, int32_t capacity);
+
+    void push(const float* magnitudes);
+    uint64_t written() const { return count.load(std::memory_order_acquire); }
+    int32_t bins() const { return binCount; }
+    int32_t capacity() const { return frames; }
+    // Copies frame `frame` into `out` (bins() bytes). False when it was not
+    // recorded yet or has been overwritten.
+    bool read(uint64_t frame, uint8_t* out) const;
+
+private:
+    int32_t binCount;
+    int32_t frames; // Ring length
+    int32_t words;  // Per column
+    std::unique_ptr<std::atomic<uint32_t>[]> cells;
+    std::vector<float> scratch; // Writer only
+    std::atomic<uint64_t> count;
+};
+
+// Rasterizes a history into an RGBA8 ring texture through a 256-entry
+// colormap LUT indexed by the stored byte. Each update draws only the
+// columns recorded since the previous one. Not thread-safe; callers lock.
+class SpectrogramRaster {
+public:
+    static constexpr int32_t MAX_HEIGHT = 1024;
+
+    SpectrogramRaster();
+
+    bool configure(int32_t width, int32_t height, float minHz, float maxHz, float sampleRate, int32_t fftSize);
+    // floorDb..ceilDb stretches over the colormap; a range change only
+    // rebuilds the LUT (and redraws), the stored history is untouched.
+    void setColormap(SpectrogramColormap colormap, float floorDb, float ceilDb);
+    void setColormap(const uint8_t* rgba, float floorDb, float ceilDb); // 256 RGBA8 entries
+    bool configured() const { return width > 0; }
+    void update(const SpectrogramHistory& history, SpectrogramView* out);
+
+private:
+    int32_t width;
+    int32_t height;
+    std::vector<int32_t> rowFirst; // Bin range per row, top row first
+    std::vector<int32_t> rowLast;
+    std::vector<uint32_t> pixels;  // RGBA8 in memory order
+    std::vector<uint8_t> column;
+    uint8_t palette[256 * 4];
+    float floorDb;
+    float ceilDb;
+    uint32_t lut[256];             // Stored byte -> pixel
+    uint64_t rendered;             // Frames drawn so far
+    bool dirty;                    // Redraw everything on the next update
+
+    void buildLut();
+    void drawColumn(int32_t x, const uint8_t* values);
+};
+
+#endif // BAREMETAL_DSP_SPECTROGRAM_H
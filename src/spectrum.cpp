@@ -0,0 +1,145 @@
+#include "spectrum.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+
+void BandMatrix::addBand(int32_t firstBin, const float* w, int32_t count) {
+    firstBins.push_back(firstBin);
+    weights.insert(weights.end(), w, w + count);
+    offsets.push_back((uint32_t)weights.size());
+}
+
+void BandMatrix::apply(const float* power, float* out) const {
+    using namespace simd;
+    for (int32_t b = 0; b < size(); ++b) {
+        const float* w = weights.data() + offsets[b];
+        const float* p = power + firstBins[b];
+        int32_t n = (int32_t)(offsets[b + 1] - offsets[b]);
+        int32_t i = 0;
+        f32x4 acc = set1(0.0f);
+        for (; i + 4 <= n; i += 4) acc = madd(load(w + i), load(p + i), acc);
+        float sum = hsum(acc);
+        for (; i < n; ++i) sum += w[i] * p[i];
+        out[b] = sum;
+    }
+}
+
+BandMatrix buildLogBands(int32_t count, float minHz, float maxHz, float sampleRate, int32_t fftSize) {
+    BandMatrix bands;
+    const int32_t bins = fftSize / 2;
+    const double hzPerBin = (double)sampleRate / fftSize;
+    const double ratio = std::pow((double)maxHz / minHz, 1.0 / count);
+    std::vector<float> w;
+
+    double lowHz = minHz;
+    for (int32_t b = 0; b < count; ++b) {
+        double highHz = lowHz * ratio;
+        double lo = lowHz / hzPerBin;
+        double hi = highHz / hzPerBin;
+        int32_t first = (int32_t)std::ceil(lo);
+        int32_t last = std::min((int32_t)std::ceil(hi) - 1, bins - 1); // Bin centers inside [lo, hi)
+
+        if (last >= first) {
+            w.assign(last - first + 1, 1.0f / (last - first + 1));
+            bands.addBand(first, w.data(), (int32_t)w.size());
+        } else {
+            // Narrower than a bin: sample the spectrum at the band center
+            double center = std::sqrt(lo * hi);
+            int32_t below = std::min((int32_t)center, bins - 2);
+            float frac = (float)std::min(center - below, 1.0);
+            w = { 1.0f - frac, frac };
+            bands.addBand(below, w.data(), 2);
+        }
+        lowHz = highHz;
+    }
+    return bands;
+}
+
+static double hz_to_mel(double hz) { return 2595.0 * std::log10(1.0 + hz / 700.0); }
+static double mel_to_hz(double mel) { return 700.0 * (std::pow(10.0, mel / 2595.0) - 1.0); }
+
+BandMatrix buildMelFilterbank(int32_t count, float minHz, float maxHz, float sampleRate, int32_t fftSize) {
+    BandMatrix bands;
+    const int32_t bins = fftSize / 2;
+    const double hzPerBin = (double)sampleRate / fftSize;
+    const double melLow = hz_to_mel(minHz);
+    const double melStep = (hz_to_mel(maxHz) - melLow) / (count + 1);
+    std::vector<float> w;
+
+    for (int32_t b = 0; b < count; ++b) {
+        double lo = mel_to_hz(melLow + b * melStep);
+        double center = mel_to_hz(melLow + (b + 1) * melStep);
+        double hi = mel_to_hz(melLow + (b + 2) * melStep);
+        double norm = 2.0 / (hi - lo);
+        int32_t first = std::max((int32_t)std::floor(lo / hzPerBin) + 1, 0);
+        int32_t last = std::min((int32_t)std::ceil(hi / hzPerBin) - 1, bins - 1);
+
+        w.clear();
+        for (int32_t k = first; k <= last; ++k) {
+            double hz = k * hzPerBin;
+            double rise = hz <= center ? (hz - lo) / (center - lo) : (hi - hz) / (hi - center);
+            w.push_back((float)(std::max(rise, 0.0) * norm));
+        }
+        if (!w.empty()) {
+            bands.addBand(first, w.data(), (int32_t)w.size());
+        } else {
+            // Triangle falls between two bins: sample the spectrum at its peak
+            double pos = center / hzPerBin;
+            int32_t below = std::min((int32_t)pos, bins - 2);
+            float frac = (float)std::min(pos - below, 1.0);
+            w = { (1.0f - frac) * (float)(norm * hzPerBin), frac * (float)(norm * hzPerBin) };
+            bands.addBand(below, w.data(), 2);
+        }
+    }
+    return bands;
+}
+
+DctTable::DctTable(int32_t in, int32_t out) : inputs(in), outputs(out), table((size_t)in * out) {
+    const double pi = 3.14159265358979323846;
+    for (int32_t k = 0; k < out; ++k) {
+        double scale = std::sqrt((k == 0 ? 1.0 : 2.0) / in);
+        for (int32_t n = 0; n < in; ++n) table[(size_t)k * in + n] = (float)(scale * std::cos(pi * k * (n + 0.5) / in));
+    }
+}
+
+void DctTable::apply(const float* in, float* out) const {
+    using namespace simd;
+    for (int32_t k = 0; k < outputs; ++k) {
+        const float* row = table.data() + (size_t)k * inputs;
+        int32_t n = 0;
+        f32x4 acc = set1(0.0f);
+        for (; n + 4 <= inputs; n += 4) acc = madd(load(row + n), load(in + n), acc);
+        float sum = hsum(acc);
+        for (; n < inputs; ++n) sum += row[n] * in[n];
+        out[k] = sum;
+    }
+}
+
+void powerToLog(const float* power, float* out, int32_t count, float floor) {
+    using namespace simd;
+    const float ln2 = 0.693147181f;
+    const f32x4 vFloor = set1(floor), vLn2 = set1(ln2);
+    int32_t i = 0;
+    for (; i + 4 <= count; i += 4) store(out + i, mul(log2Approx(max(load(power + i), vFloor)), vLn2));
+    for (; i < count; ++i) out[i] = std::log(std::max(power[i], floor));
+}
+
+void powerToNormalizedDb(const float* power, float* out, int32_t count, float floorDb, float ceilDb) {
+    using namespace simd;
+    // 10*log10(p) = log2(p) * 10*log10(2); fold the normalization into one madd
+    const float dbPerLog2 = 3.01029996f;
+    const float scale = dbPerLog2 / (ceilDb - floorDb);
+    const float offset = -floorDb / (ceilDb - floorDb);
+    const f32x4 tiny = set1(1e-20f), vScale = set1(scale), vOffset = set1(offset);
+    const f32x4 zero = set1(0.0f), one = set1(1.0f);
+
+    int32_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        f32x4 v = madd(log2Approx(max(load(power + i), tiny)), vScale, vOffset);
+        store(out + i, min(max(v, zero), one));
+    }
+    for (; i < count; ++i) {
+        float v = std::log2(std::max(power[i], 1e-20f)) * scale + offset;
+        out[i] = std::min(std::max(v, 0.0f), 1.0f);
+    }
+}
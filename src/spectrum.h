@@ -0,0 +1,53 @@
+#ifndef BAREMETAL_DSP_SPECTRUM_H
+#define BAREMETAL_DSP_SPECTRUM_H
+
+#include <vector>
+#include <cstdint>
+
+// Sparse band matrix over power-spectrum bins: every band is a weighted sum
+// of one contiguous run of bins, precomputed once per configuration.
+class BandMatrix {
+public:
+    BandMatrix() : offsets(1, 0) {}
+
+    void addBand(int32_t firstBin, const float* weights, int32_t count);
+    int32_t size() const { return (int32_t)firstBins.size(); }
+    void apply(const float* power, float* out) const;
+
+private:
+    std::vector<int32_t> firstBins;
+    std::vector<uint32_t> offsets; // Into `weights`, size() + 1 entries
+    std::vector<float> weights;
+};
+
+// `count` log-spaced bands between minHz and maxHz, each the mean power of
+// the bins it covers; bands narrower than a bin interpolate between the two
+// nearest bins instead of repeating one.
+BandMatrix buildLogBands(int32_t count, float minHz, float maxHz, float sampleRate, int32_t fftSize);
+
+// `count` triangular filters evenly spaced on the mel scale (HTK formula),
+// area-normalized so every band measures power density alike (Slaney).
+BandMatrix buildMelFilterbank(int32_t count, float minHz, float maxHz, float sampleRate, int32_t fftSize);
+
+// Orthonormal DCT-II of `inputs` values down to the first `outputs`
+// coefficients, as one precomputed outputs x inputs cosine table.
+class DctTable {
+public:
+    DctTable(int32_t inputs, int32_t outputs);
+
+    void apply(const float* in, float* out) const;
+
+private:
+    int32_t inputs;
+    int32_t outputs;
+    std::vector<float> table;
+};
+
+// out[i] = ln(max(power[i], floor)) with the SIMD fast log.
+void powerToLog(const float* power, float* out, int32_t count, float floor);
+
+// out[i] = clamp((10*log10(power[i]) - floorDb) / (ceilDb - floorDb), 0, 1)
+// with the SIMD fast log.
+void powerToNormalizedDb(const float* power, float* out, int32_t count, float floorDb, float ceilDb);
+
+#endif // BAREMETAL_DSP_SPECTRUM_H
@@ -0,0 +1,52 @@
+#ifndef BAREMETAL_DSP_SPSC_QUEUE_H
+#define BAREMETAL_DSP_SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+
+// Bounded single-producer single-consumer ring. Neither side ever blocks or
+// allocates, so either end may be the audio thread. Indices run freely and
+// are masked on access; head and tail sit on separate cache lines.
+template <typename T, uint32_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // --- Producer ---
+    bool push(const T& item) { return pushAll(&item, 1); }
+
+    // All or nothing: the consumer sees the whole batch at once or none of it.
+    bool pushAll(const T* items, uint32_t count) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (count > Capacity - (t - head.load(std::memory_order_acquire))) return false;
+        for (uint32_t i = 0; i < count; ++i) slots[(t + i) & (Capacity - 1)] = items[i];
+        tail.store(t + count, std::memory_order_release);
+        return true;
+    }
+
+    // --- Consumer ---
+    const T* front() const {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return nullptr;
+        return &slots[h & (Capacity - 1)];
+    }
+
+    void pop() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    bool pop(T& out) {
+        const T* item = front();
+        if (!item) return false;
+        out = *item;
+        pop();
+        return true;
+    }
+
+private:
+    alignas(64) std::atomic<uint32_t> head; // Consumer-owned
+    alignas(64) std::atomic<uint32_t> tail; // Producer-owned
+    alignas(64) T slots[Capacity];
+};
+
+#endif // BAREMETAL_DSP_SPSC_QUEUE_H
@@ -0,0 +1,820 @@
+#include "subtitles.h"
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+// --- Cue Table ---
+CueTableBuilder::CueTableBuilder() : table(std::make_unique<CueTable>()) {
+    internStyle("Default", 7);
+}
+
+uint32_t CueTableBuilder::appendToArena(const char* text, size_t length) {
+    uint32_t offset = (uint32_t)table->arena.size();
+    table->arena.insert(table->arena.end(), text, text + length);
+    table->arena.push_back('\0');
+    return offset;
+}
+
+void CueTableBuilder::add(double startTime, double endTime, const char* text, size_t length,
+                          int16_t layer, uint16_t styleId) {
+    SubtitleCue cue;
+    cue.startTime = startTime;
+    cue.endTime = endTime;
+    cue.textOffset = appendToArena(text, length);
+    cue.textLength = (uint32_t)length;
+    cue.layer = layer;
+    cue.styleId = styleId;
+    table->cues.push_back(cue);
+}
+
+uint16_t CueTableBuilder::internStyle(const char* name, size_t length) {
+    const std::vector<uint32_t>& styles = table->styleOffsets;
+    for (size_t id = 0; id < styles.size(); ++id) {
+        const char* existing = table->arena.data() + styles[id];
+        if (std::strlen(existing) == length && std::memcmp(existing, name, length) == 0) return (uint16_t)id;
+    }
+    if (styles.size() > UINT16_MAX) return 0;
+    table->styleOffsets.push_back(appendToArena(name, length));
+    return (uint16_t)(styles.size() - 1);
+}
+
+std::unique_ptr<CueTable> CueTableBuilder::build() {
+    std::stable_sort(table->cues.begin(), table->cues.end(),
+        [](const SubtitleCue& a, const SubtitleCue& b) { return a.startTime < b.startTime; });
+    table->buildIndex();
+    std::unique_ptr<CueTable> result = std::move(table);
+    table = std::make_unique<CueTable>();
+    internStyle("Default", 7);
+    return result;
+}
+
+void CueTable::describe(int32_t index, SubtitleCueInfo* out) const {
+    const SubtitleCue& c = cues[index];
+    out->index = index;
+    out->layer = c.layer;
+    out->styleId = c.styleId;
+    out->startTime = c.startTime;
+    out->endTime = c.endTime;
+    out->text = arena.data() + c.textOffset;
+    out->textLength = (int32_t)c.textLength;
+}
+
+int32_t CueTable::firstStartingAfter(double t) const {
+    auto it = std::upper_bound(cues.begin(), cues.end(), t,
+        [](double value, const SubtitleCue& c) { return value < c.startTime; });
+    return (int32_t)(it - cues.begin());
+}
+
+int32_t CueSource::upcoming(double t, SubtitleCueInfo* out, int32_t count) const {
+    int32_t first = firstStartingAfter(t);
+    int32_t n = std::max(0, std::min(count, size() - first));
+    for (int32_t i = 0; i < n; ++i) describe(first + i, &out[i]);
+    return n;
+}
+
+// Level-k nodes sit at indices whose k lowest bits are 1 (leaves are the even
+// indices); maxEnd[i] is the largest end time in the subtree rooted at i.
+void CueTable::buildIndex() {
+    const size_t n = cues.size();
+    maxEnd.assign(n, 0.0);
+    if (n == 0) { rootLevel = -1; return; }
+
+    size_t lastI = 0;
+    double last = 0.0;
+    for (size_t i = 0; i < n; i += 2) { lastI = i; last = maxEnd[i] = cues[i].endTime; }
+
+    int32_t k = 1;
+    for (; ((size_t)1 << k) <= n; ++k) {
+        const size_t x = (size_t)1 << (k - 1), step = x << 2;
+        for (size_t i = (x << 1) - 1; i < n; i += step) {
+            double left = maxEnd[i - x];
+            double right = (i + x < n) ? maxEnd[i + x] : last;
+            maxEnd[i] = std::max(cues[i].endTime, std::max(left, right));
+        }
+        lastI = ((lastI >> k) & 1) ? lastI - x : lastI + x;
+        if (lastI < n && maxEnd[lastI] > last) last = maxEnd[lastI];
+    }
+    rootLevel = k - 1;
+}
+
+int32_t CueTable::queryActive(double t, int32_t* out, int32_t capacity) const {
+    if (rootLevel < 0 || capacity <= 0) return 0;
+
+    struct Node { size_t x; int32_t k; bool leftDone; };
+    Node stack[64];
+    int32_t top = 0, found = 0;
+    const size_t n = cues.size();
+
+    stack[top++] = { ((size_t)1 << rootLevel) - 1, rootLevel, false };
+    while (top > 0 && found < capacity) {
+        Node z = stack[--top];
+        if (z.k <= 3) {
+            // Small subtree: a linear scan beats further descent
+            size_t i0 = z.x >> z.k << z.k;
+            size_t i1 = std::min(i0 + ((size_t)1 << (z.k + 1)) - 1, n);
+            for (size_t i = i0; i < i1 && cues[i].startTime <= t && found < capacity; ++i) {
+                if (t <= cues[i].endTime) out[found++] = (int32_t)i;
+            }
+        } else if (!z.leftDone) {
+            size_t y = z.x - ((size_t)1 << (z.k - 1));
+            stack[top++] = { z.x, z.k, true };
+            if (y >= n || maxEnd[y] >= t) stack[top++] = { y, z.k - 1, false };
+        } else if (z.x < n && cues[z.x].startTime <= t) {
+            if (t <= cues[z.x].endTime) out[found++] = (int32_t)z.x;
+            stack[top++] = { z.x + ((size_t)1 << (z.k - 1)), z.k - 1, false };
+        }
+    }
+    return found;
+}
+
+// --- Parsers ---
+namespace {
+
+struct LineReader {
+    const char* p;
+    const char* end;
+
+    LineReader(const char* data, size_t length) : p(data), end(data + length) {
+        if (length >= 3 && std::memcmp(p, "\xEF\xBB\xBF", 3) == 0) p += 3; // UTF-8 BOM
+    }
+
+    bool next(const char*& line, size_t& length) {
+        if (p >= end) return false;
+        const char* nl = (const char*)std::memchr(p, '\n', (size_t)(end - p));
+        const char* stop = nl ? nl : end;
+        line = p;
+        length = (size_t)(stop - p);
+        if (length > 0 && line[length - 1] == '\r') --length;
+        p = nl ? nl + 1 : end;
+        return true;
+    }
+};
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+inline bool isBlank(char c) { return c == ' ' || c == '\t'; }
+
+bool startsWithNoCase(const char* s, size_t length, const char* prefix) {
+    size_t n = std::strlen(prefix);
+    if (length < n) return false;
+    for (size_t i = 0; i < n; ++i) {
+        char a = s[i], b = prefix[i];
+        if (a >= 'A' && a <= 'Z') a = (char)(a - 'A' + 'a');
+        if (b >= 'A' && b <= 'Z') b = (char)(b - 'A' + 'a');
+        if (a != b) return false;
+    }
+    return true;
+}
+
+void trim(const char*& s, size_t& length) {
+    while (length > 0 && isBlank(*s)) { ++s; --length; }
+    while (length > 0 && isBlank(s[length - 1])) --length;
+}
+
+// Accepts "hh:mm:ss,mmm" (SRT), "[hh:]mm:ss.ttt" (WebVTT) and "h:mm:ss.cc"
+// (ASS): two or three colon-separated fields plus an optional fraction of any
+// precision. Advances `p` past the timestamp.
+bool scanTimestamp(const char*& p, const char* end, double& seconds) {
+    while (p < end && isBlank(*p)) ++p;
+    uint64_t fields[3];
+    int count = 0;
+    for (;;) {
+        if (p >= end || !isDigit(*p)) return false;
+        uint64_t v = 0;
+        while (p < end && isDigit(*p)) v = v * 10 + (uint64_t)(*p++ - '0');
+        fields[count++] = v;
+        if (count < 3 && p < end && *p == ':') { ++p; continue; }
+        break;
+    }
+    if (count < 2) return false;
+
+    uint64_t fraction = 0, scale = 1;
+    if (p < end && (*p == '.' || *p == ',')) {
+        ++p;
+        while (p < end && isDigit(*p)) {
+            if (scale < 1000000000ull) { fraction = fraction * 10 + (uint64_t)(*p - '0'); scale *= 10; }
+            ++p;
+        }
+    }
+    seconds = (count == 3) ? fields[0] * 3600.0 + fields[1] * 60.0 + (double)fields[2]
+                           : fields[0] * 60.0 + (double)fields[1];
+    seconds += (double)fraction / (double)scale;
+    return true;
+}
+
+bool parseTimingLine(const char* line, size_t length, double& start, double& end) {
+    const char* stop = line + length;
+    const char* arrow = nullptr;
+    for (const char* q = line; q + 3 <= stop; ++q) {
+        if (q[0] == '-' && q[1] == '-' && q[2] == '>') { arrow = q; break; }
+    }
+    if (!arrow) return false;
+    const char* p = line;
+    if (!scanTimestamp(p, arrow, start)) return false;
+    p = arrow + 3;
+    return scanTimestamp(p, stop, end);
+}
+
+// WebVTT payload: drop <tags> and decode the common character references.
+void appendVttText(std::string& out, const char* s, size_t length) {
+    static const struct { const char* name; char value; } entities[] = {
+        { "&amp;", '&' }, { "&lt;", '<' }, { "&gt;", '>' }, { "&nbsp;", ' ' }, { "&quot;", '"' }
+    };
+    for (size_t i = 0; i < length; ++i) {
+        char c = s[i];
+        if (c == '<') {
+            const char* close = (const char*)std::memchr(s + i, '>', length - i);
+            if (close) { i = (size_t)(close - s); continue; }
+        } else if (c == '&') {
+            bool decoded = false;
+            for (const auto& e : entities) {
+                size_t n = std::strlen(e.name);
+                if (length - i >= n && std::memcmp(s + i, e.name, n) == 0) {
+                    out += e.value; i += n - 1; decoded = true; break;
+                }
+            }
+            if (decoded) continue;
+        }
+        out += c;
+    }
+}
+
+// ASS event text: drop {override} blocks, map \N \n to newlines and \h to a space.
+void appendAssText(std::string& out, const char* s, size_t length) {
+    for (size_t i = 0; i < length; ++i) {
+        char c = s[i];
+        if (c == '{') {
+            const char* close = (const char*)std::memchr(s + i, '}', length - i);
+            if (close) { i = (size_t)(close - s); continue; }
+        } else if (c == '\\' && i + 1 < length) {
+            char e = s[i + 1];
+            if (e == 'N' || e == 'n') { out += '\n'; ++i; continue; }
+            if (e == 'h') { out += ' '; ++i; continue; }
+        }
+        out += c;
+    }
+}
+
+// SRT and WebVTT share the block layout: optional identifier, a "-->" timing
+// line, payload lines, blank line.
+std::unique_ptr<CueTable> parseTimedBlocks(const char* data, size_t length, bool webVtt) {
+    CueTableBuilder builder;
+    LineReader reader(data, length);
+    std::string text;
+    const char* line;
+    size_t n;
+    double start = 0.0, end = 0.0;
+    bool inCue = false, skipBlock = false, blockStart = true;
+
+    auto flush = [&]() {
+        if (inCue && !text.empty()) builder.add(start, end, text.data(), text.size());
+        text.clear();
+        inCue = false;
+    };
+
+    while (reader.next(line, n)) {
+        if (n == 0) { flush(); skipBlock = false; blockStart = true; continue; }
+        if (blockStart && webVtt &&
+            (startsWithNoCase(line, n, "WEBVTT") || startsWithNoCase(line, n, "NOTE") ||
+             startsWithNoCase(line, n, "STYLE") || startsWithNoCase(line, n, "REGION"))) {
+            skipBlock = true;
+        }
+        blockStart = false;
+        if (skipBlock) continue;
+
+        if (!inCue) {
+            if (parseTimingLine(line, n, start, end)) inCue = true;
+            continue; // Cue identifiers and stray lines are ignored
+        }
+        if (!text.empty()) text += '\n';
+        if (webVtt) appendVttText(text, line, n);
+        else text.append(line, n);
+    }
+    flush();
+    return builder.build();
+}
+
+} // namespace
+
+SubtitleFormat detectSubtitleFormat(const char* data, size_t length) {
+    LineReader reader(data, length);
+    const char* line;
+    size_t n;
+    while (reader.next(line, n)) {
+        trim(line, n);
+        if (n == 0) continue;
+        if (startsWithNoCase(line, n, "WEBVTT")) return SubtitleFormat::WEBVTT;
+        if (startsWithNoCase(line, n, "[Script Info]") || startsWithNoCase(line, n, "[Events]"))
+            return SubtitleFormat::ASS;
+        return SubtitleFormat::SRT;
+    }
+    return SubtitleFormat::SRT;
+}
+
+std::unique_ptr<CueTable> parseSrt(const char* data, size_t length) {
+    return parseTimedBlocks(data, length, false);
+}
+
+std::unique_ptr<CueTable> parseWebVtt(const char* data, size_t length) {
+    return parseTimedBlocks(data, length, true);
+}
+
+std::unique_ptr<CueTable> parseAss(const char* data, size_t length) {
+    enum class Section { OTHER, STYLES, EVENTS } section = Section::OTHER;
+    // Field positions from the section's "Format:" line (spec defaults until
+    // one is seen; a Format line replaces them, -1 for an absent field)
+    int styleNameField = 0, styleFieldCount = 23;
+    int layerField = 0, startField = 1, endField = 2, styleField = 3, textField = 9, eventFieldCount = 10;
+
+    CueTableBuilder builder;
+    LineReader reader(data, length);
+    std::string text;
+    const char* line;
+    size_t n;
+    const char* fields[32];
+    size_t lengths[32];
+
+    // Splits "Key: a,b,c" into at most `maxFields`; the last field keeps any commas.
+    auto split = [&](const char* s, size_t len, int maxFields) {
+        const char* colon = (const char*)std::memchr(s, ':', len);
+        const char* p = colon + 1;
+        const char* stop = s + len;
+        int count = 0;
+        while (count < maxFields) {
+            const char* comma = (count + 1 < maxFields) ? (const char*)std::memchr(p, ',', (size_t)(stop - p)) : nullptr;
+            const char* fieldEnd = comma ? comma : stop;
+            fields[count] = p;
+            lengths[count] = (size_t)(fieldEnd - p);
+            trim(fields[count], lengths[count]);
+            ++count;
+            if (!comma) break;
+            p = comma + 1;
+        }
+        return count;
+    };
+
+    while (reader.next(line, n)) {
+        trim(line, n);
+        if (n == 0 || line[0] == ';') continue;
+        if (line[0] == '[') {
+            if (startsWithNoCase(line, n, "[Events]")) section = Section::EVENTS;
+            else if (startsWithNoCase(line, n, "[V4+ Styles]") || startsWithNoCase(line, n, "[V4 Styles]")) section = Section::STYLES;
+            else section = Section::OTHER;
+            continue;
+        }
+        if (section == Section::OTHER) continue;
+
+        if (startsWithNoCase(line, n, "Format:")) {
+            int count = split(line, n, 32);
+            if (section == Section::STYLES) {
+                styleFieldCount = count;
+                styleNameField = -1;
+                for (int i = 0; i < count; ++i)
+                    if (startsWithNoCase(fields[i], lengths[i], "Name")) styleNameField = i;
+            } else {
+                eventFieldCount = count;
+                layerField = startField = endField = styleField = textField = -1;
+                for (int i = 0; i < count; ++i) {
+                    if (startsWithNoCase(fields[i], lengths[i], "Layer")) layerField = i;
+                    else if (startsWithNoCase(fields[i], lengths[i], "Start")) startField = i;
+                    else if (startsWithNoCase(fields[i], lengths[i], "End")) endField = i;
+                    else if (startsWithNoCase(fields[i], lengths[i], "Style")) styleField = i;
+                    else if (startsWithNoCase(fields[i], lengths[i], "Text")) textField = i;
+                }
+            }
+        } else if (section == Section::STYLES && startsWithNoCase(line, n, "Style:")) {
+            int count = split(line, n, styleFieldCount);
+            if (styleNameField >= 0 && styleNameField < count) builder.internStyle(fields[styleNameField], lengths[styleNameField]);
+        } else if (section == Section::EVENTS && startsWithNoCase(line, n, "Dialogue:")) {
+            int count = split(line, n, eventFieldCount);
+            if (count < eventFieldCount || startField < 0 || endField < 0 || textField < 0) continue;
+
+            double start, end;
+            const char* p = fields[startField];
+            if (!scanTimestamp(p, fields[startField] + lengths[startField], start)) continue;
+            p = fields[endField];
+            if (!scanTimestamp(p, fields[endField] + lengths[endField], end)) continue;
+
+            int layer = 0;
+            for (size_t i = 0; layerField >= 0 && i < lengths[layerField] && isDigit(fields[layerField][i]); ++i)
+                layer = std::min(layer * 10 + (fields[layerField][i] - '0'), (int)INT16_MAX);
+
+            text.clear();
+            appendAssText(text, fields[textField], lengths[textField]);
+            if (text.empty()) continue;
+            uint16_t styleId = styleField >= 0 ? builder.internStyle(fields[styleField], lengths[styleField]) : 0;
+            builder.add(start, end, text.data(), text.size(), (int16_t)layer, styleId);
+        }
+    }
+    return builder.build();
+}
+
+std::unique_ptr<CueTable> parseSubtitles(const char* data, size_t length) {
+    switch (detectSubtitleFormat(data, length)) {
+        case SubtitleFormat::WEBVTT: return parseWebVtt(data, length);
+        case SubtitleFormat::ASS:    return parseAss(data, length);
+        default:                     return parseSrt(data, length);
+    }
+}
+
+// --- Live Store ---
+LiveCueStore::LiveCueStore() : count(0), amendSequence(0), styleTotal(0), textUsed(0), textCapacity(0) {
+    for (auto& chunk : chunks) chunk.store(nullptr, std::memory_order_relaxed);
+    for (auto& name : styleNames) name.store(nullptr, std::memory_order_relaxed);
+    internStyle("Default", 7);
+}
+
+LiveCueStore::~LiveCueStore() {
+    for (auto& chunk : chunks) delete[] chunk.load(std::memory_order_relaxed);
+}
+
+const char* LiveCueStore::storeText(const char* text, size_t length) {
+    if (textUsed + length + 1 > textCapacity) {
+        size_t blockSize = std::max(TEXT_BLOCK_SIZE, length + 1);
+        textBlocks.emplace_back(new char[blockSize]);
+        textUsed = 0;
+        textCapacity = blockSize;
+    }
+    char* dst = textBlocks.back().get() + textUsed;
+    std::memcpy(dst, text, length);
+    dst[length] = '\0';
+    textUsed += length + 1;
+    return dst;
+}
+
+uint16_t LiveCueStore::internStyle(const char* name, size_t length) {
+    int32_t total = styleTotal.load(std::memory_order_relaxed);
+    for (int32_t id = 0; id < total; ++id) {
+        const char* existing = styleNames[id].load(std::memory_order_relaxed);
+        if (std::strlen(existing) == length && std::memcmp(existing, name, length) == 0) return (uint16_t)id;
+    }
+    if (total >= MAX_STYLES) return 0;
+    styleNames[total].store(storeText(name, length), std::memory_order_release);
+    styleTotal.store(total + 1, std::memory_order_release);
+    return (uint16_t)total;
+}
+
+bool LiveCueStore::append(double startTime, double endTime, const char* text, size_t length,
+                          int16_t layer, uint16_t styleId) {
+    int32_t n = count.load(std::memory_order_relaxed);
+    if (n >= MAX_CHUNKS * CHUNK_SIZE) return false;
+    if (n > 0 && startTime < cueAt(n - 1).startTime) return false;
+
+    if ((n & (CHUNK_SIZE - 1)) == 0) chunks[n >> CHUNK_SHIFT].store(new LiveCue[CHUNK_SIZE], std::memory_order_release);
+    LiveCue& cue = cueAt(n);
+    double previousMax = (n > 0) ? cueAt(n - 1).maxEnd.load(std::memory_order_relaxed) : endTime;
+    double chunkMax = (n & (CHUNK_SIZE - 1)) ? cueAt(n - 1).chunkMaxEnd.load(std::memory_order_relaxed) : endTime;
+    cue.startTime = startTime;
+    cue.endTime.store(endTime, std::memory_order_relaxed);
+    cue.maxEnd.store(std::max(previousMax, endTime), std::memory_order_relaxed);
+    cue.chunkMaxEnd.store(std::max(chunkMax, endTime), std::memory_order_relaxed);
+    cue.text.store(storeText(text, length), std::memory_order_relaxed);
+    cue.textLength.store((uint32_t)length, std::memory_order_relaxed);
+    cue.layer = layer;
+    cue.styleId = styleId;
+
+    count.store(n + 1, std::memory_order_release);
+    return true;
+}
+
+bool LiveCueStore::amendLast(double endTime, const char* text, size_t length) {
+    int32_t n = count.load(std::memory_order_relaxed);
+    if (n == 0) return false;
+    LiveCue& cue = cueAt(n - 1);
+    // The old text stays in the arena, so pointers already handed out remain valid
+    const char* stored = text ? storeText(text, length) : nullptr;
+
+    uint32_t seq = amendSequence.load(std::memory_order_relaxed);
+    amendSequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    if (endTime >= 0.0) {
+        double previousMax = (n > 1) ? cueAt(n - 2).maxEnd.load(std::memory_order_relaxed) : endTime;
+        double chunkMax = ((n - 1) & (CHUNK_SIZE - 1)) ? cueAt(n - 2).chunkMaxEnd.load(std::memory_order_relaxed) : endTime;
+        cue.endTime.store(endTime, std::memory_order_relaxed);
+        cue.maxEnd.store(std::max(previousMax, endTime), std::memory_order_relaxed);
+        cue.chunkMaxEnd.store(std::max(chunkMax, endTime), std::memory_order_relaxed);
+    }
+    if (stored) {
+        cue.text.store(stored, std::memory_order_relaxed);
+        cue.textLength.store((uint32_t)length, std::memory_order_relaxed);
+    }
+    amendSequence.store(seq + 2, std::memory_order_release);
+    return true;
+}
+
+double LiveCueStore::endTime(int32_t index) const {
+    return cueAt(index).endTime.load(std::memory_order_acquire);
+}
+
+const char* LiveCueStore::text(int32_t index) const {
+    return cueAt(index).text.load(std::memory_order_acquire);
+}
+
+void LiveCueStore::describe(int32_t index, SubtitleCueInfo* out) const {
+    const LiveCue& cue = cueAt(index);
+    out->index = index;
+    out->layer = cue.layer;
+    out->styleId = cue.styleId;
+    out->startTime = cue.startTime;
+    for (;;) {
+        uint32_t seq = amendSequence.load(std::memory_order_acquire);
+        if (seq & 1) continue;
+        out->endTime = cue.endTime.load(std::memory_order_relaxed);
+        out->text = cue.text.load(std::memory_order_relaxed);
+        out->textLength = (int32_t)cue.textLength.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (amendSequence.load(std::memory_order_relaxed) == seq) return;
+    }
+}
+
+int32_t LiveCueStore::firstStartingAfter(double t) const {
+    int32_t lo = 0, hi = size();
+    while (lo < hi) {
+        int32_t mid = lo + (hi - lo) / 2;
+        if (cueAt(mid).startTime <= t) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+int32_t LiveCueStore::queryActive(double t, int32_t* out, int32_t capacity) const {
+    if (capacity <= 0) return 0;
+    int32_t found = 0;
+    // Both running maxima are non-decreasing in the index: the store-wide one
+    // ends the scan, the per-chunk one skips the rest of a chunk with nothing
+    // active. Collected newest first, returned ascending.
+    int32_t i = firstStartingAfter(t) - 1;
+    while (i >= 0 && found < capacity) {
+        const LiveCue& cue = cueAt(i);
+        if (cue.maxEnd.load(std::memory_order_relaxed) < t) break;
+        if (cue.chunkMaxEnd.load(std::memory_order_relaxed) < t) {
+            i = (i & ~(CHUNK_SIZE - 1)) - 1;
+            continue;
+        }
+        if (t <= cue.endTime.load(std::memory_order_relaxed)) out[found++] = i;
+        --i;
+    }
+    std::reverse(out, out + found);
+    return found;
+}
+
+// --- Active Set ---
+ActiveCueSet::ActiveCueSet() : sequence(0), count(0), firstIndex(-1) {
+    for (auto& index : indices) index.store(-1, std::memory_order_relaxed);
+}
+
+void ActiveCueSet::publish(const int32_t* src, int32_t n) {
+    uint32_t seq = sequence.load(std::memory_order_relaxed);
+    sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    count.store(n, std::memory_order_relaxed);
+    for (int32_t i = 0; i < n; ++i) indices[i].store(src[i], std::memory_order_relaxed);
+
+    sequence.store(seq + 2, std::memory_order_release);
+    firstIndex.store(n > 0 ? src[0] : -1, std::memory_order_release);
+}
+
+int32_t ActiveCueSet::read(int32_t* out, int32_t capacity) const {
+    for (;;) {
+        uint32_t seq = sequence.load(std::memory_order_acquire);
+        if (seq & 1) continue;
+        int32_t n = count.load(std::memory_order_relaxed);
+        int32_t copied = std::min(n, capacity);
+        for (int32_t i = 0; i < copied; ++i) out[i] = indices[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == seq) return n;
+    }
+}
+
+// --- Track ---
+SubtitleTrack::SubtitleTrack() :
+    current(nullptr), tableVersion(0), syncedVersion(~0u), syncedCount(0),
+    syncedTime(0.0), nextStart(0.0), activeUntil(0.0), liveStore(nullptr),
+    hasPending(false), loaderExit(false), loadGeneration(0), loadStatus((int32_t)SubtitleLoadState::IDLE)
+{
+    std::fill_n(syncedIndices, MAX_ACTIVE_SUBTITLES, -1);
+}
+
+SubtitleTrack::~SubtitleTrack() {
+    stopLoader();
+    delete current.load();
+    for (const CueSource* r : retired) delete r;
+}
+
+// Caller holds writerMutex.
+void SubtitleTrack::swapSource(const CueSource* source) {
+    const CueSource* old = current.exchange(source);
+    tableVersion.fetch_add(1, std::memory_order_release);
+    if (old) retired.push_back(old);
+}
+
+void SubtitleTrack::notifyChanged() {
+    if (onPublish) onPublish();
+}
+
+void SubtitleTrack::publish(std::unique_ptr<CueTable> table) {
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        liveStore = nullptr;
+        swapSource(table.release());
+    }
+    notifyChanged();
+}
+
+int32_t SubtitleTrack::append(const char* data, size_t length) {
+    std::unique_ptr<CueTable> fragment = parseSubtitles(data, length);
+    int32_t appended = 0;
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        if (!liveStore) {
+            liveStore = new LiveCueStore();
+            swapSource(liveStore);
+        }
+        for (int32_t i = 0; i < fragment->size(); ++i) {
+            const SubtitleCue& cue = fragment->cue(i);
+            const char* style = fragment->styleName(cue.styleId);
+            uint16_t styleId = liveStore->internStyle(style, std::strlen(style));
+            if (liveStore->append(cue.startTime, cue.endTime, fragment->text(i), cue.textLength, cue.layer, styleId))
+                ++appended;
+        }
+        tableVersion.fetch_add(1, std::memory_order_release);
+    }
+    notifyChanged();
+    return appended;
+}
+
+bool SubtitleTrack::amendLast(double endTime, const char* text, size_t length) {
+    bool amended;
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        amended = liveStore && liveStore->amendLast(endTime, text, length);
+        if (amended) tableVersion.fetch_add(1, std::memory_order_release);
+    }
+    if (amended) notifyChanged();
+    return amended;
+}
+
+void SubtitleTrack::loadFileAsync(const char* path) {
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex);
+        if (loaderExit) return;
+        pendingPath = path;
+        hasPending = true;
+        ++loadGeneration;
+        loadStatus.store((int32_t)SubtitleLoadState::LOADING, std::memory_order_release);
+        if (!loader.joinable()) loader = std::thread(&SubtitleTrack::loaderLoop, this);
+    }
+    loaderWake.notify_one();
+}
+
+void SubtitleTrack::loaderLoop() {
+    std::unique_lock<std::mutex> lock(loaderMutex);
+    for (;;) {
+        loaderWake.wait(lock, [this] { return hasPending || loaderExit; });
+        if (loaderExit) return;
+        std::string path = std::move(pendingPath);
+        uint32_t generation = loadGeneration;
+        hasPending = false;
+        lock.unlock();
+
+        // Parse straight out of the page cache: no read() copy, no UTF-16 round
+        // trip. A file that yields no cues fails like a missing one and keeps
+        // the current table.
+        MappedFile file;
+        std::unique_ptr<CueTable> table;
+        if (file.open(path.c_str())) table = parseSubtitles(file.data(), file.size());
+        file.close();
+        bool ok = table && table->size() > 0;
+
+        // Published under the loader lock, so a cancel either drops this
+        // result or runs after it
+        lock.lock();
+        if (generation != loadGeneration) continue; // Superseded or cancelled
+        if (ok) publish(std::move(table));
+        loadStatus.store((int32_t)(ok ? SubtitleLoadState::READY : SubtitleLoadState::FAILED),
+                         std::memory_order_release);
+    }
+}
+
+void SubtitleTrack::cancelLoad() {
+    std::lock_guard<std::mutex> lock(loaderMutex);
+    pendingPath.clear();
+    hasPending = false;
+    ++loadGeneration;
+    loadStatus.store((int32_t)SubtitleLoadState::IDLE, std::memory_order_release);
+}
+
+void SubtitleTrack::stopLoader() {
+    cancelLoad();
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex);
+        loaderExit = true;
+    }
+    loaderWake.notify_one();
+    if (loader.joinable()) loader.join();
+}
+
+bool SubtitleTrack::sync(double timestamp) {
+    uint32_t version = tableVersion.load(std::memory_order_acquire);
+    if (version == syncedVersion && timestamp >= syncedTime &&
+        timestamp < nextStart && timestamp <= activeUntil) return false;
+
+    const CueSource* source = current.load();
+
+    const double never = std::numeric_limits<double>::infinity();
+    int32_t found[MAX_ACTIVE_SUBTITLES] = {};
+    int32_t n = 0;
+    nextStart = never;
+    activeUntil = never;
+    if (source) {
+        n = source->queryActive(timestamp, found, MAX_ACTIVE_SUBTITLES);
+        for (int32_t i = 0; i < n; ++i) activeUntil = std::min(activeUntil, source->endTime(found[i]));
+        int32_t next = source->firstStartingAfter(timestamp);
+        if (next < source->size()) nextStart = source->startTime(next);
+    }
+    syncedTime = timestamp;
+
+    bool changed = (version != syncedVersion) || (n != syncedCount) ||
+                   !std::equal(found, found + n, syncedIndices);
+    if (changed) {
+        activeSet.publish(found, n);
+        syncedVersion = version;
+        syncedCount = n;
+        std::copy(found, found + n, syncedIndices);
+    }
+    return changed;
+}
+
+// The active set changes when t reaches nextStart or passes activeUntil
+// (cue ends are inclusive), so the latter is nudged just past the end.
+double SubtitleTrack::nextBoundary() const {
+    return std::min(nextStart, activeUntil + 1e-4);
+}
+
+// --- Track Set ---
+SubtitleTrackSet::SubtitleTrackSet() : openMask(1u), changeGeneration(0) {}
+
+int32_t SubtitleTrackSet::open() {
+    std::lock_guard<std::mutex> lock(openMutex);
+    uint32_t mask = openMask.load(std::memory_order_relaxed);
+    for (int32_t i = 1; i < MAX_SUBTITLE_TRACKS; ++i) {
+        if (!(mask & (1u << i))) {
+            openMask.store(mask | (1u << i), std::memory_order_release);
+            return i;
+        }
+    }
+    return -1;
+}
+
+void SubtitleTrackSet::close(int32_t handle) {
+    if (handle < 0 || handle >= MAX_SUBTITLE_TRACKS) return;
+    std::lock_guard<std::mutex> lock(openMutex);
+    // The next sync pass sees the null source and clears the active set
+    tracks[handle].cancelLoad();
+    tracks[handle].publish(nullptr);
+    if (handle != 0) openMask.fetch_and(~(1u << handle), std::memory_order_release);
+}
+
+SubtitleTrack* SubtitleTrackSet::track(int32_t handle) {
+    if (handle < 0 || handle >= MAX_SUBTITLE_TRACKS) return nullptr;
+    return (openMask.load(std::memory_order_acquire) & (1u << handle)) ? &tracks[handle] : nullptr;
+}
+
+const SubtitleTrack* SubtitleTrackSet::track(int32_t handle) const {
+    if (handle < 0 || handle >= MAX_SUBTITLE_TRACKS) return nullptr;
+    return (openMask.load(std::memory_order_acquire) & (1u << handle)) ? &tracks[handle] : nullptr;
+}
+
+// Closed tracks are visited too (their source is null) so they settle empty.
+void SubtitleTrackSet::sync(double timestamp) {
+    bool changed = false;
+    for (SubtitleTrack& t : tracks) changed |= t.sync(timestamp);
+    if (changed) changeGeneration.fetch_add(1, std::memory_order_release);
+}
+
+double SubtitleTrackSet::nextBoundary() const {
+    double boundary = std::numeric_limits<double>::infinity();
+    for (const SubtitleTrack& t : tracks) boundary = std::min(boundary, t.nextBoundary());
+    return boundary;
+}
+
+void SubtitleTrackSet::setPublishListener(const std::function<void()>& listener) {
+    for (SubtitleTrack& t : tracks) t.setPublishListener(listener);
+}
+
+void SubtitleTrackSet::stopLoaders() {
+    for (SubtitleTrack& t : tracks) t.stopLoader();
+}
+
+int32_t SubtitleTrackSet::readActive(SubtitleActiveEntry* out, int32_t capacity) const {
+    uint32_t mask = openMask.load(std::memory_order_acquire);
+    int32_t total = 0;
+    for (int32_t t = 0; t < MAX_SUBTITLE_TRACKS && total < capacity; ++t) {
+        if (!(mask & (1u << t))) continue;
+        int32_t indices[MAX_ACTIVE_SUBTITLES];
+        int32_t n = std::min(tracks[t].active().read(indices, MAX_ACTIVE_SUBTITLES), MAX_ACTIVE_SUBTITLES);
+        for (int32_t i = 0; i < n && total < capacity; ++i) out[total++] = { t, indices[i] };
+    }
+    return total;
+}
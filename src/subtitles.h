@@ -0,0 +1,312 @@
+#ifndef BAREMETAL_DSP_SUBTITLES_H
+#define BAREMETAL_DSP_SUBTITLES_H
+
+#include <atomic>
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+#define MAX_ACTIVE_SUBTITLES 8
+#define MAX_SUBTITLE_TRACKS 8
+
+struct SubtitleCue {
+    double startTime;
+    double endTime;
+    uint32_t textOffset; // Offset into the table's text arena
+    uint32_t textLength; // Bytes, excluding the NUL terminator
+    int16_t layer;       // ASS layer, 0 for SRT/WebVTT
+    uint16_t styleId;    // Index into the table's style names, 0 = "Default"
+};
+
+// FFI view of one cue (layout mirrored in lib/ffi_bridge.dart)
+struct SubtitleCueInfo {
+    int32_t index;
+    int16_t layer;
+    uint16_t styleId;
+    double startTime;
+    double endTime;
+    const char* text;
+    int32_t textLength;
+};
+
+// FFI view of one active cue across all tracks
+struct SubtitleActiveEntry {
+    int32_t track;
+    int32_t index;
+};
+
+// Read-only cue view shared by immutable tables and live stores. Indices are
+// ordered by start time and stay valid for the lifetime of the source.
+class CueSource {
+public:
+    virtual ~CueSource() = default;
+
+    virtual int32_t size() const = 0;
+    virtual double startTime(int32_t index) const = 0;
+    virtual double endTime(int32_t index) const = 0;
+    virtual const char* text(int32_t index) const = 0;
+    virtual void describe(int32_t index, SubtitleCueInfo* out) const = 0;
+    virtual int32_t styleCount() const = 0;
+    virtual const char* styleName(int32_t id) const = 0;
+
+    // Writes the indices of every cue with start <= t <= end (ascending) into
+    // `out`, up to `capacity`. Returns the number written.
+    virtual int32_t queryActive(double t, int32_t* out, int32_t capacity) const = 0;
+    // Index of the first cue starting strictly after t (size() if none).
+    virtual int32_t firstStartingAfter(double t) const = 0;
+    // Describes up to `count` cues starting after t: one binary search, then
+    // a contiguous read. Returns the number written.
+    int32_t upcoming(double t, SubtitleCueInfo* out, int32_t count) const;
+};
+
+// Immutable cue table: cues sorted by start time, all texts packed in one
+// NUL-separated arena, plus an implicit augmented interval tree (the sorted
+// array itself is the tree, `maxEnd` is the per-node augmentation).
+class CueTable final : public CueSource {
+public:
+    int32_t size() const override { return (int32_t)cues.size(); }
+    const SubtitleCue& cue(int32_t index) const { return cues[index]; }
+    double startTime(int32_t index) const override { return cues[index].startTime; }
+    double endTime(int32_t index) const override { return cues[index].endTime; }
+    const char* text(int32_t index) const override { return arena.data() + cues[index].textOffset; }
+    void describe(int32_t index, SubtitleCueInfo* out) const override;
+    int32_t styleCount() const override { return (int32_t)styleOffsets.size(); }
+    const char* styleName(int32_t id) const override { return arena.data() + styleOffsets[id]; }
+
+    // O(log n + k) through the interval tree.
+    int32_t queryActive(double t, int32_t* out, int32_t capacity) const override;
+    int32_t firstStartingAfter(double t) const override;
+
+private:
+    friend class CueTableBuilder;
+
+    std::vector<SubtitleCue> cues;
+    std::vector<double> maxEnd;
+    std::vector<char> arena;
+    std::vector<uint32_t> styleOffsets; // Style names, also stored in the arena
+    int32_t rootLevel = -1;
+
+    void buildIndex();
+};
+
+class CueTableBuilder {
+public:
+    CueTableBuilder();
+
+    void add(double startTime, double endTime, const char* text, size_t length,
+             int16_t layer = 0, uint16_t styleId = 0);
+    // Returns the compact ID for a style name, registering it on first use.
+    uint16_t internStyle(const char* name, size_t length);
+    // Sorts the cues by start time and builds the interval index.
+    std::unique_ptr<CueTable> build();
+
+private:
+    std::unique_ptr<CueTable> table;
+
+    uint32_t appendToArena(const char* text, size_t length);
+};
+
+enum class SubtitleFormat { SRT, WEBVTT, ASS };
+
+SubtitleFormat detectSubtitleFormat(const char* data, size_t length);
+std::unique_ptr<CueTable> parseSrt(const char* data, size_t length);
+std::unique_ptr<CueTable> parseWebVtt(const char* data, size_t length);
+std::unique_ptr<CueTable> parseAss(const char* data, size_t length);
+// Sniffs the format and dispatches to the matching parser.
+std::unique_ptr<CueTable> parseSubtitles(const char* data, size_t length);
+
+// Fixed-capacity set of active cue indices, published by the sync path with a
+// sequence lock so readers on any thread get a consistent snapshot.
+class ActiveCueSet {
+public:
+    ActiveCueSet();
+
+    void publish(const int32_t* indices, int32_t count);
+    // Copies up to `capacity` indices into `out`, returns the total count.
+    int32_t read(int32_t* out, int32_t capacity) const;
+    int32_t first() const { return firstIndex.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<uint32_t> sequence;
+    std::atomic<int32_t> count;
+    std::atomic<int32_t> indices[MAX_ACTIVE_SUBTITLES];
+    std::atomic<int32_t> firstIndex;
+};
+
+// Append-only cue store for live captions. Cues live in fixed-size chunks and
+// texts in never-moving arena blocks, so indices and text pointers stay valid
+// while the single writer appends. Only the last cue can be amended; readers
+// see it through a sequence lock. Starts must be non-decreasing.
+class LiveCueStore final : public CueSource {
+public:
+    static constexpr int32_t CHUNK_SHIFT = 8;
+    static constexpr int32_t CHUNK_SIZE = 1 << CHUNK_SHIFT;
+    static constexpr int32_t MAX_CHUNKS = 4096;
+    static constexpr int32_t MAX_STYLES = 64;
+    static constexpr size_t TEXT_BLOCK_SIZE = 64 * 1024;
+
+    LiveCueStore();
+    ~LiveCueStore() override;
+
+    // Writer side; callers serialize (the owning track holds its writer lock).
+    bool append(double startTime, double endTime, const char* text, size_t length,
+                int16_t layer = 0, uint16_t styleId = 0);
+    // Negative end time keeps the current end, null text keeps the current text.
+    bool amendLast(double endTime, const char* text, size_t length);
+    uint16_t internStyle(const char* name, size_t length);
+
+    int32_t size() const override { return count.load(std::memory_order_acquire); }
+    double startTime(int32_t index) const override { return cueAt(index).startTime; }
+    double endTime(int32_t index) const override;
+    const char* text(int32_t index) const override;
+    void describe(int32_t index, SubtitleCueInfo* out) const override;
+    int32_t styleCount() const override { return styleTotal.load(std::memory_order_acquire); }
+    const char* styleName(int32_t id) const override { return styleNames[id].load(std::memory_order_acquire); }
+
+    // O(log n) search, then a backwards scan: one step per chunk back to the
+    // oldest still-active cue, plus up to CHUNK_SIZE cues in each chunk that
+    // holds an active cue. A single long cue no longer makes it O(n).
+    int32_t queryActive(double t, int32_t* out, int32_t capacity) const override;
+    int32_t firstStartingAfter(double t) const override;
+
+private:
+    struct LiveCue {
+        double startTime;
+        std::atomic<double> endTime;
+        std::atomic<double> maxEnd;      // Largest end over cues [0, index]
+        std::atomic<double> chunkMaxEnd; // Largest end over the chunk's cues up to index
+        std::atomic<const char*> text;
+        std::atomic<uint32_t> textLength;
+        int16_t layer;
+        uint16_t styleId;
+    };
+
+    std::atomic<LiveCue*> chunks[MAX_CHUNKS];
+    std::atomic<int32_t> count;
+    std::atomic<uint32_t> amendSequence;
+    std::atomic<const char*> styleNames[MAX_STYLES];
+    std::atomic<int32_t> styleTotal;
+
+    // Writer-only arena bookkeeping
+    std::vector<std::unique_ptr<char[]>> textBlocks;
+    size_t textUsed;
+    size_t textCapacity;
+
+    LiveCue& cueAt(int32_t index) const {
+        return chunks[index >> CHUNK_SHIFT].load(std::memory_order_acquire)[index & (CHUNK_SIZE - 1)];
+    }
+    const char* storeText(const char* text, size_t length);
+};
+
+enum class SubtitleLoadState : int32_t {
+    FAILED = -1,
+    IDLE = 0,
+    LOADING = 1,
+    READY = 2
+};
+
+// One subtitle track: the published cue table and its active set. Replaced
+// tables are retired, not freed, until the track is destroyed: the sync
+// thread and UI text pointers may still reference them, and reloads are rare
+// enough that keeping them costs less than tracking every reader. `sync` runs
+// on a single reader thread; loads may come from any other thread.
+class SubtitleTrack {
+public:
+    SubtitleTrack();
+    ~SubtitleTrack();
+
+    // Replaces the whole track (a live store, if any, is retired too).
+    void publish(std::unique_ptr<CueTable> table);
+    // Live captions: parses a fragment (any supported format) and appends its
+    // cues without invalidating existing indices. Returns the number appended;
+    // cues starting before the current last cue are dropped.
+    int32_t append(const char* data, size_t length);
+    bool amendLast(double endTime, const char* text, size_t length);
+    // Memory-maps and parses the file on the track's loader thread, then
+    // publishes it. Superseded requests are coalesced to the newest path. A
+    // file that cannot be opened or yields no cues ends FAILED.
+    void loadFileAsync(const char* path);
+    // Drops a queued load and discards one in flight; the state returns to IDLE.
+    void cancelLoad();
+    // Cancels any load and joins the loader; later loadFileAsync calls are ignored.
+    void stopLoader();
+    SubtitleLoadState loadState() const { return (SubtitleLoadState)loadStatus.load(std::memory_order_acquire); }
+
+    // Returns true when the active set changed. Between cue boundaries this
+    // is a version compare and two double compares, no search.
+    bool sync(double timestamp);
+    // Media time of the next active-set change after the last sync (sync thread only).
+    double nextBoundary() const;
+    // Called on the publishing thread after every table swap.
+    void setPublishListener(std::function<void()> listener) { onPublish = std::move(listener); }
+
+    const CueSource* source() const { return current.load(std::memory_order_acquire); }
+    const ActiveCueSet& active() const { return activeSet; }
+
+private:
+    std::atomic<const CueSource*> current;
+    std::atomic<uint32_t> tableVersion; // Bumped on every swap or append (no ABA on reused addresses)
+    ActiveCueSet activeSet;
+
+    // Reader-thread state
+    uint32_t syncedVersion;
+    int32_t syncedCount;
+    int32_t syncedIndices[MAX_ACTIVE_SUBTITLES];
+    double syncedTime;
+    double nextStart;    // Earliest start after syncedTime
+    double activeUntil;  // Earliest end among the active cues
+
+    std::mutex writerMutex;
+    std::vector<const CueSource*> retired; // Freed in the destructor
+    LiveCueStore* liveStore; // Writer side of `current` while in live mode
+
+    std::thread loader;
+    std::mutex loaderMutex;
+    std::condition_variable loaderWake;
+    std::string pendingPath;
+    bool hasPending;
+    bool loaderExit;
+    uint32_t loadGeneration; // Bumped per request or cancel; stale parses are dropped
+    std::atomic<int32_t> loadStatus;
+    std::function<void()> onPublish;
+
+    void swapSource(const CueSource* source);
+    void notifyChanged();
+    void loaderLoop();
+};
+
+// Fixed pool of tracks addressed by small integer handles. Track 0 is always
+// open and backs the single-track API. All tracks are synced in one pass and a
+// shared generation counter tells readers whether anything changed at all.
+class SubtitleTrackSet {
+public:
+    SubtitleTrackSet();
+
+    int32_t open();             // Returns a handle, or -1 when the pool is full
+    void close(int32_t handle); // Track 0 cannot be closed, only emptied
+    SubtitleTrack* track(int32_t handle);
+    const SubtitleTrack* track(int32_t handle) const;
+
+    void sync(double timestamp);
+    double nextBoundary() const; // Earliest boundary over all tracks (sync thread only)
+    void setPublishListener(const std::function<void()>& listener);
+    // Joins every loader so no publish (and no listener call) can follow.
+    void stopLoaders();
+    uint32_t generation() const { return changeGeneration.load(std::memory_order_acquire); }
+    // Active cues of every open track, ordered by track then index.
+    int32_t readActive(SubtitleActiveEntry* out, int32_t capacity) const;
+
+private:
+    SubtitleTrack tracks[MAX_SUBTITLE_TRACKS];
+    std::atomic<uint32_t> openMask;
+    std::atomic<uint32_t> changeGeneration;
+    std::mutex openMutex;
+};
+
+#endif // BAREMETAL_DSP_SUBTITLES_H
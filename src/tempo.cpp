@@ -0,0 +1,104 @@
+#include "tempo.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+TempoTracker::TempoTracker(float sampleRate, int32_t hopSize)
+    : sampleRate(sampleRate), hopSize(hopSize) {
+    const float hopRate = sampleRate / hopSize;
+    minLag = std::max(1, (int32_t)std::ceil(60.0f * hopRate / MAX_BPM));
+    maxLag = std::min(MAX_LAGS - 1, (int32_t)std::floor(60.0f * hopRate / MIN_BPM));
+    decay = std::exp(-1.0f / (MEMORY_SECONDS * hopRate));
+    warmupHops = (int32_t)(WARMUP_SECONDS * hopRate);
+    for (int32_t l = 0; l < MAX_LAGS; ++l) {
+        float octaves = l > 0 ? std::log2(60.0f * hopRate / l / PRIOR_BPM) / PRIOR_OCTAVES : 0.0f;
+        prior[l] = std::exp(-0.5f * octaves * octaves);
+    }
+    reset();
+}
+
+void TempoTracker::reset() {
+    std::fill(acf, acf + 2 * MAX_LAGS + 1, 0.0f);
+    std::fill(envelope, envelope + HISTORY, 0.0f);
+    std::fill(score, score + HISTORY, 0.0);
+    std::fill(position, position + HISTORY, 0.0);
+    hops = 0;
+    weight = 0.0f;
+    mean = 0.0f;
+    meanSquare = 0.0f;
+    periodHops = 0.0f;
+    currentBpm = 0.0f;
+    currentConfidence = 0.0f;
+    beatPosition = -1.0;
+}
+
+void TempoTracker::process(float novelty, double framePosition) {
+    const int32_t mask = HISTORY - 1;
+    const int64_t n = hops++;
+
+    // Scale-free envelope: divide by the running RMS. The autocorrelation sees
+    // its square root, so alternating strong and weak hits (kick, snare) still
+    // correlate at one beat, minus the running mean. Both averages are
+    // divided by their accumulated weight, so they are unbiased from the
+    // first hop instead of ramping up from zero.
+    weight = decay * weight + (1.0f - decay);
+    meanSquare = decay * meanSquare + (1.0f - decay) * novelty * novelty;
+    const float o = novelty / std::sqrt(meanSquare / weight + 1e-12f);
+    mean = decay * mean + (1.0f - decay) * std::sqrt(o);
+    const float x = std::sqrt(o) - mean / weight;
+    envelope[n & mask] = x;
+    position[n & mask] = framePosition;
+
+    const int32_t lags = (int32_t)std::min<int64_t>(2 * maxLag + 1, n);
+    for (int32_t l = 0; l <= lags; ++l) acf[l] = decay * acf[l] + x * envelope[(n - l) & mask];
+    if (n >= warmupHops) updateTempo();
+
+    // Forward DP: best predecessor between half and two periods back
+    double best = 0.0;
+    if (periodHops > 0.0f) {
+        const int64_t first = std::max<int64_t>(0, n - (int64_t)std::lround(2.0f * periodHops));
+        const int64_t last = n - std::max<int64_t>(1, std::lround(0.5f * periodHops));
+        best = -std::numeric_limits<double>::infinity();
+        for (int64_t p = first; p <= last; ++p) {
+            double ratio = std::log((double)(n - p) / periodHops);
+            best = std::max(best, score[p & mask] - TIGHTNESS * ratio * ratio);
+        }
+        if (!std::isfinite(best)) best = 0.0;
+    }
+    score[n & mask] = o + best;
+
+    // Latest beat: the best cumulative score within the last period
+    if (periodHops > 0.0f) {
+        const int64_t first = std::max<int64_t>(0, n - (int64_t)std::lround(periodHops) + 1);
+        int64_t beat = n;
+        for (int64_t p = first; p < n; ++p) {
+            if (score[p & mask] > score[beat & mask]) beat = p;
+        }
+        beatPosition = position[beat & mask];
+    }
+}
+
+void TempoTracker::updateTempo() {
+    if (acf[0] <= 0.0f) return;
+    int32_t bestLag = 0;
+    float bestScore = 0.0f;
+    // A period between two hop lags splits its peak over both, so every lag
+    // counts with its stronger neighbour
+    auto peak = [this](int32_t l) { return acf[l] + std::max(acf[l - 1], acf[l + 1]); };
+    float scores[MAX_LAGS] = {};
+    for (int32_t l = minLag; l <= maxLag; ++l) {
+        scores[l] = prior[l] * (peak(l) + 0.5f * peak(2 * l));
+        if (scores[l] > bestScore) { bestScore = scores[l]; bestLag = l; }
+    }
+    if (bestLag == 0) return; // No positive periodicity yet
+
+    float offset = 0.0f;
+    if (bestLag > minLag && bestLag < maxLag) {
+        float a = scores[bestLag - 1], b = scores[bestLag], c = scores[bestLag + 1];
+        float denominator = a - 2.0f * b + c;
+        if (denominator < 0.0f) offset = std::clamp(0.5f * (a - c) / denominator, -0.5f, 0.5f);
+    }
+    periodHops = bestLag + offset;
+    currentBpm = 60.0f * sampleRate / hopSize / periodHops;
+    currentConfidence = std::clamp(acf[bestLag] / acf[0], 0.0f, 1.0f);
+}
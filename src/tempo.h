@@ -0,0 +1,76 @@
+#ifndef BAREMETAL_DSP_TEMPO_H
+#define BAREMETAL_DSP_TEMPO_H
+
+#include <cstdint>
+
+// FFI view of the tempo tracker (layout mirrored in lib/ffi_bridge.dart).
+// Everything is 0 until a tempo has been found.
+struct TempoStats {
+    double bpm;
+    double confidence; // Periodicity of the onset envelope at the tempo, 0..1
+    double period;     // Seconds per beat
+    double lastBeat;   // Media-clock seconds of the latest tracked beat
+    double nextBeat;   // First predicted beat after the clock's current time
+    double phase;      // 0..1 at the clock's current time, 0 on the beat
+};
+
+// Tempo and beats from the per-hop onset envelope, updated one hop at a time.
+// Tempo: a leaky autocorrelation of the normalized envelope (one multiply-add
+// per lag per hop instead of a windowed recomputation), scored as a two-term
+// comb, acf(l) + acf(2l)/2, under a log-Gaussian prior around PRIOR_BPM, with
+// parabolic refinement of the best lag. Beats: Ellis' dynamic program run
+// forwards; each hop's cumulative score is its onset strength plus the best
+// predecessor half to two periods back, penalized by TIGHTNESS * log(gap /
+// period)^2. The latest beat is the best-scoring hop of the last period.
+// Single-threaded: the audio thread owns it.
+class TempoTracker {
+public:
+    static constexpr float MIN_BPM = 50.0f;
+    static constexpr float MAX_BPM = 240.0f;
+    static constexpr float PRIOR_BPM = 120.0f;
+    static constexpr float PRIOR_OCTAVES = 0.8f; // Standard deviation of the prior
+    static constexpr float MEMORY_SECONDS = 8.0f; // Autocorrelation and normalization time constant
+    static constexpr float WARMUP_SECONDS = 3.0f; // Before any tempo is reported
+    static constexpr float TIGHTNESS = 100.0f;
+    static constexpr int32_t HISTORY = 256;       // Hops kept, power of two
+    static constexpr int32_t MAX_LAGS = 128;
+
+    TempoTracker(float sampleRate, int32_t hopSize);
+
+    void reset();
+    // `novelty` is the hop's onset strength, `position` the content frame it
+    // belongs to
+    void process(float novelty, double position);
+
+    float bpm() const { return currentBpm; }
+    float confidence() const { return currentConfidence; }
+    double period() const { return periodHops * hopSize; } // Content frames, 0 before a tempo
+    double lastBeat() const { return beatPosition; }       // Content frame, -1 before a beat
+
+private:
+    float sampleRate;
+    int32_t hopSize;
+    int32_t minLag;
+    int32_t maxLag;      // Comb reads up to 2 * maxLag
+    float decay;         // Per hop
+    int32_t warmupHops;
+
+    float prior[MAX_LAGS];
+    float acf[2 * MAX_LAGS + 1];
+    float envelope[HISTORY]; // Mean-removed normalized novelty
+    double score[HISTORY];   // Cumulative DP score
+    double position[HISTORY];
+    int64_t hops;
+    float weight; // Of the running averages, 1 - decay^hops
+    float mean;
+    float meanSquare;
+
+    float periodHops;
+    float currentBpm;
+    float currentConfidence;
+    double beatPosition;
+
+    void updateTempo();
+};
+
+#endif // BAREMETAL_DSP_TEMPO_H
@@ -0,0 +1,98 @@
+#include "true_peak.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// BS.1770-4 Annex 2, Table 1: phase p holds taps p, p + 4, ..., p + 44
+static const float ANNEX2_PHASES[4][12] = {
+    { 0.0017089843750f, 0.0109863281250f, -0.0196533203125f, 0.0332031250000f, -0.0594482421875f, 0.1373291015625f,
+      0.9721679687500f, -0.1022949218750f, 0.0476074218750f, -0.0266113281250f, 0.0148925781250f, -0.0083007812500f },
+    { -0.0291748046875f, 0.0292968750000f, -0.0517578125000f, 0.0891113281250f, -0.1665039062500f, 0.4650878906250f,
+      0.7797851562500f, -0.2003173828125f, 0.1015625000000f, -0.0582275390625f, 0.0330810546875f, -0.0189208984375f },
+    { -0.0189208984375f, 0.0330810546875f, -0.0582275390625f, 0.1015625000000f, -0.2003173828125f, 0.7797851562500f,
+      0.4650878906250f, -0.1665039062500f, 0.0891113281250f, -0.0517578125000f, 0.0292968750000f, -0.0291748046875f },
+    { -0.0083007812500f, 0.0148925781250f, -0.0266113281250f, 0.0476074218750f, -0.1022949218750f, 0.9721679687500f,
+      0.1373291015625f, -0.0594482421875f, 0.0332031250000f, -0.0196533203125f, 0.0109863281250f, 0.0017089843750f }
+};
+
+static double to_db(float linear) {
+    return linear > 0.0f ? 20.0 * std::log10((double)linear) : -std::numeric_limits<double>::infinity();
+}
+
+TruePeakMeter::TruePeakMeter(float rate) : sampleRate(rate) {
+    for (int32_t t = 0; t < TAPS; ++t)
+        for (int32_t p = 0; p < PHASES; ++p) coefficients[t][p] = ANNEX2_PHASES[p][t];
+    reset();
+}
+
+void TruePeakMeter::reset() {
+    std::fill_n(buffer, TAPS - 1, 0.0f);
+    sample = {};
+    truePeak = {};
+}
+
+void TruePeakMeter::advance(Ballistics& b, float peak, float seconds) {
+    const float fall = std::pow(10.0f, -DECAY_DB_PER_SECOND * seconds / 20.0f);
+    b.display = std::max(peak, b.display * fall);
+    b.max = std::max(b.max, peak);
+    if (peak >= b.hold) {
+        b.hold = peak;
+        b.holdAge = 0.0f;
+    } else if ((b.holdAge += seconds) > HOLD_SECONDS) {
+        b.hold = b.display; // Released: restart from the falling display
+        b.holdAge = 0.0f;
+    }
+}
+
+void TruePeakMeter::process(const float* in, uint32_t n) {
+    using namespace simd;
+    const f32x4 zero = set1(0.0f);
+    f32x4 taps[TAPS];
+    for (int32_t t = 0; t < TAPS; ++t) taps[t] = load(coefficients[t]);
+
+    for (uint32_t start = 0; start < n; start += CHUNK) {
+        uint32_t m = std::min(n - start, CHUNK);
+        float* x = buffer + TAPS - 1; // x[-11..-1] is the previous chunk's tail
+        std::memcpy(x, in + start, m * sizeof(float));
+
+        f32x4 samplePeak = zero, interPeak = zero;
+        uint32_t i = 0;
+        for (; i + 4 <= m; i += 4) {
+            f32x4 v = load(x + i);
+            samplePeak = max(samplePeak, max(v, sub(zero, v)));
+        }
+        float sampleTail = 0.0f;
+        for (; i < m; ++i) sampleTail = std::max(sampleTail, std::fabs(x[i]));
+
+        // Four interpolated outputs per input: lane p = phase p
+        for (i = 0; i < m; ++i) {
+            const float* newest = x + i;
+            f32x4 y = mul(set1(newest[0]), taps[0]);
+            for (int32_t t = 1; t < TAPS; ++t) y = madd(set1(newest[-t]), taps[t], y);
+            interPeak = max(interPeak, max(y, sub(zero, y)));
+        }
+        std::memmove(buffer, x + m - (TAPS - 1), (TAPS - 1) * sizeof(float));
+
+        float lanes[4];
+        store(lanes, samplePeak);
+        float peak = std::max(std::max(lanes[0], lanes[1]), std::max(std::max(lanes[2], lanes[3]), sampleTail));
+        store(lanes, interPeak);
+        // The true peak is never below the sample peak (the FIR only approximates it)
+        float tp = std::max(std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3])), peak);
+
+        float seconds = m / sampleRate;
+        advance(sample, peak, seconds);
+        advance(truePeak, tp, seconds);
+    }
+}
+
+void TruePeakMeter::stats(PeakStats* out) const {
+    out->samplePeak = to_db(sample.display);
+    out->truePeak = to_db(truePeak.display);
+    out->samplePeakHold = to_db(sample.hold);
+    out->truePeakHold = to_db(truePeak.hold);
+    out->maxSamplePeak = to_db(sample.max);
+    out->maxTruePeak = to_db(truePeak.max);
+}
@@ -0,0 +1,53 @@
+#ifndef BAREMETAL_DSP_TRUE_PEAK_H
+#define BAREMETAL_DSP_TRUE_PEAK_H
+
+#include <cstdint>
+
+// FFI view of the peak meters (layout mirrored in lib/ffi_bridge.dart).
+// dBFS / dBTP; -infinity for digital silence.
+struct PeakStats {
+    double samplePeak;     // Instant rise, DECAY_DB_PER_SECOND fall
+    double truePeak;
+    double samplePeakHold; // Highest peak of the last HOLD_SECONDS
+    double truePeakHold;
+    double maxSamplePeak;  // Since start or the last reset
+    double maxTruePeak;
+};
+
+// ITU-R BS.1770-4 Annex 2 true-peak meter: 4x oversampling through the
+// Annex's 48-tap polyphase FIR. The four phases are the four lanes of one
+// vector, so each input sample costs 12 vector multiply-adds. Ballistics
+// advance with the audio, not with the reader's polling rate.
+// Single-threaded: the audio thread owns it.
+class TruePeakMeter {
+public:
+    static constexpr int32_t PHASES = 4;
+    static constexpr int32_t TAPS = 12;              // Per phase
+    static constexpr uint32_t CHUNK = 256;
+    static constexpr float HOLD_SECONDS = 2.0f;
+    static constexpr float DECAY_DB_PER_SECOND = 20.0f / 1.7f; // IEC 60268-18 PPM fall
+
+    explicit TruePeakMeter(float sampleRate);
+
+    void reset();
+    void process(const float* in, uint32_t n);
+    void stats(PeakStats* out) const;
+
+private:
+    struct Ballistics {
+        float display; // Linear
+        float hold;
+        float holdAge; // Seconds
+        float max;
+    };
+
+    float coefficients[TAPS][PHASES]; // Tap-major: one vector per tap
+    float buffer[TAPS - 1 + CHUNK];   // Last TAPS - 1 inputs, then the chunk
+    float sampleRate;
+    Ballistics sample;
+    Ballistics truePeak;
+
+    static void advance(Ballistics& b, float peak, float seconds);
+};
+
+#endif // BAREMETAL_DSP_TRUE_PEAK_H